@@ -0,0 +1,91 @@
+/**
+ * Header       benchCases.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      The cases of the benchmark, shared by the native benchmark and the 
+ *              benchmark sketch. Each case converts all analog values 0 .. Amax once 
+ *              with one backend of NTCsensor:
+ * 
+ *              beta     Beta formula, with log() or, with NTC_FIXED_POINT, in integers
+ *              sh       Steinhart-Hart model with the fast ln() 
+ *              lut      lookup table of 65 entries built at runtime
+ * 
+ *              The driver measures the time of runCase() and divides it by the 
+ *              conversions it returns. loopIdle() measures a pass of 
+ *              NTCthermostat::loop() with nothing due.
+ */
+#ifndef _BENCHCASES_H_
+#define _BENCHCASES_H_
+#include <Arduino.h>
+#include "NTCsensor.h"
+#include "NTCthermostat.h"
+
+enum BenchCase { BENCH_BETA, BENCH_SH, BENCH_LUT, BENCH_CASES };
+
+static const char *benchNames[BENCH_CASES] = { "beta", "sh", "lut" };
+
+// 10k NTC, B 3950 and Steinhart-Hart coefficients of the same type
+ParamsSH  benchSH   = { 1.009249522e-3, 2.378405444e-4, 2.019202697e-7 };
+ParamsNTC benchBeta = { 10000, 10000, 3950, nullptr };
+ParamsNTC benchSHH  = { 10000, 10000, 3950, &benchSH };
+#ifdef ESP32
+  ParamsADC benchAdc = { A0, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0, nullptr };
+#else
+  ParamsADC benchAdc = { A0, true, 1023, 5000.0, 5000.0, 0.0, nullptr };
+#endif
+
+NTCsensor benchBetaSensor(benchBeta, benchAdc);
+NTCsensor benchSHSensor(benchSHH, benchAdc);
+NTCsensor benchLutSensor(benchBeta, benchAdc);
+int16_t   benchLut[65];
+
+volatile int32_t benchSink;               // keeps the compiler from dropping the conversions
+
+NTCsensor &benchSensor(BenchCase c)
+{
+    static bool isBuilt = false;
+    if (! isBuilt)
+    {
+        benchLutSensor.buildLookupTable(benchLut, 65);
+        isBuilt = true;
+    }
+    switch (c)
+    {
+        case BENCH_SH:  return benchSHSensor;
+        case BENCH_LUT: return benchLutSensor;
+        default:        return benchBetaSensor;
+    }
+}
+
+/**
+ * Convert all analog values once, returns the number of conversions
+ */
+uint32_t runCase(BenchCase c)
+{
+    NTCsensor &s   = benchSensor(c);
+    int32_t    sum = 0;
+
+    for (uint32_t a = 0; a <= benchAdc.Amax; a++)
+    {
+        s.add((uint16_t)a);
+        sum += s.getReading().cCelsius;
+    }
+    benchSink = sum;
+    return benchAdc.Amax + 1;
+}
+
+NTCthermostat benchThermostat(benchBetaSensor, nullptr, nullptr, nullptr);
+
+/**
+ * n passes of loop() with nothing due
+ */
+uint32_t loopIdle(uint32_t n)
+{
+    benchThermostat.setRefreshInterval(0xFFFFFFF0UL);
+    benchThermostat.disable();
+    benchThermostat.enable();
+    benchThermostat.loop();               // the first tick is due at once
+    for (uint32_t i = 0; i < n; i++) benchThermostat.loop();
+    return n;
+}
+#endif
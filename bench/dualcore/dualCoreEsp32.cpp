@@ -0,0 +1,89 @@
+/**
+ * Program      dualCoreEsp32.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Benchmark sketch which measures the jitter of the ticks of NTCthermostat
+ *              on the ESP32 while loop() prints without pause. In the first phase the
+ *              thermostat runs in loop(), from then on in the control task of NTCdualCore.
+ *              After each phase the largest deviation of the period of the samples from
+ *              the refresh interval is printed.
+ *
+ * Build        pio run -e bench_dualcore -t upload && pio device monitor -e bench_dualcore
+ */
+
+#include <Arduino.h>
+#include "NTCthermostat.h"
+#include "NTCdualCore.h"
+
+#ifndef BENCH_PHASE_MS
+  #define BENCH_PHASE_MS 60000UL    // duration of a phase
+#endif
+#define BENCH_INTERVAL   100        // ms, refresh interval of the thermostat
+#define BENCH_LINE       120        // characters printed per pass of loop()
+
+ParamsNTC ntcRs10k = { 10000, 10000, 2800 };
+ParamsADC adcEsp32 = { A6, true, 4095, ADC_11db, 3300.0, 3200.0, 130.0 };
+
+void processData(void *ctx, const Reading &reading);
+
+NTCsensor     ntcSensor(ntcRs10k, adcEsp32);
+NTCthermostat thermostat(ntcSensor, nullptr, nullptr, processData);
+NTCdualCore   dualCore(thermostat, nullptr);
+
+static volatile bool isDualCore = false;
+static uint32_t usLast      = 0;
+static uint32_t usJitterMax = 0;
+static uint32_t msPhase;
+static char     line[BENCH_LINE + 1];
+
+/**
+ * In loop() the jitter is measured here, in the control task by push()
+ */
+void processData(void *ctx, const Reading &reading)
+{
+    if (isDualCore)
+    {
+        dualCore.push(reading);
+        return;
+    }
+    uint32_t usNow = micros();
+    if (usLast != 0)
+    {
+        int32_t  dev = (int32_t)(usNow - usLast - BENCH_INTERVAL * 1000UL);
+        uint32_t abs = dev < 0 ? -dev : dev;
+        if (abs > usJitterMax) usJitterMax = abs;
+    }
+    usLast = usNow;
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(500);
+    memset(line, '.', BENCH_LINE);
+    thermostat.setRefreshInterval(BENCH_INTERVAL);
+    thermostat.enable();
+    msPhase = millis();
+}
+
+void loop()
+{
+    if (isDualCore) dualCore.loop();
+    else            thermostat.loop();
+    Serial.println(line);                   // blocks once the buffer of the UART is full
+
+    if (millis() - msPhase < BENCH_PHASE_MS) return;
+    if (! isDualCore)
+    {
+        Serial.printf("\nloop()       max. jitter %lu us\n", (unsigned long)usJitterMax);
+        isDualCore = true;
+        dualCore.begin();
+    }
+    else
+    {
+        Serial.printf("\nNTCdualCore  max. jitter %lu us, dropped %lu\n",
+                      (unsigned long)dualCore.getMaxJitter(), (unsigned long)dualCore.getDropped());
+        dualCore.resetJitter();
+    }
+    msPhase = millis();
+}
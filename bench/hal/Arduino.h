@@ -0,0 +1,70 @@
+/**
+ * Header       Arduino.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Minimal Arduino HAL for the native env of platformio.ini, so the 
+ *              libraries can be built and measured on the host without a board.
+ * 
+ *              analogRead()  returns halAnalogValue or the value of halAnalogRead
+ *              millis()      real time since the start, or the virtual time set 
+ *                            with halSetMillis()
+ *              Serial        writes to stdout
+ */
+#ifndef _ARDUINO_NATIVE_H_
+#define _ARDUINO_NATIVE_H_
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define INPUT   0
+#define OUTPUT  1
+#define LOW     0
+#define HIGH    1
+#define A0      14
+#define LED_BUILTIN 13
+
+#define PROGMEM
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define F(s) s
+#define noInterrupts()
+#define interrupts()
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+int  analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int  digitalRead(uint8_t pin);
+
+// HAL controls
+extern uint16_t halAnalogValue;
+extern uint16_t (*halAnalogRead)(uint8_t pin);
+void halSetMillis(uint32_t ms);           // switch to virtual time
+void halRealTime();                       // back to real time
+
+class HardwareSerial
+{
+    public:
+        void   begin(unsigned long) {}
+        size_t print(const char *s)   { return fputs(s, stdout) < 0 ? 0 : strlen(s); }
+        size_t print(int i)           { return printf("%d", i); }
+        size_t println(const char *s = "") { return print(s) + print("\n"); }
+        size_t println(int i)         { return print(i) + print("\n"); }
+        size_t write(uint8_t b)       { return fputc(b, stdout) == EOF ? 0 : 1; }
+        size_t write(const uint8_t *b, size_t n) { return fwrite(b, 1, n, stdout); }
+        int    availableForWrite()    { return 64; }
+        int    available()            { return 0; }
+        int    read()                 { return -1; }
+        void   flush()                { fflush(stdout); }
+};
+extern HardwareSerial Serial;
+#endif
@@ -0,0 +1,107 @@
+/**
+ * Program      benchNative.cpp
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Benchmark of the conversion backends of NTCsensor and of 
+ *              NTCthermostat::loop() on the host. Reports ns per conversion and the 
+ *              largest deviation in °C from the exact model in the range NTC_LUT_TMIN 
+ *              .. NTC_LUT_TMAX. The numbers are only comparable on the same machine,
+ *              use them to see regressions and the relations between the backends.
+ * 
+ * Build        pio run -e native        && .pio/build/native/program
+ *              pio run -e native_fixed  && .pio/build/native_fixed/program
+ */
+
+#include <chrono>
+#include "benchCases.h"
+
+static const uint16_t repeats = 2000;     // rounds over all analog values per case
+
+static double nsSince(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * Temperature with the exact formula and log()
+ */
+static double exactCelsius(BenchCase c, double rt)
+{
+    if (c == BENCH_SH)
+    {
+        double x = log(rt);
+        return 1.0 / (benchSH.A + benchSH.B * x + benchSH.C * x * x * x) - 273.15;
+    }
+    return 1.0 / (1.0 / 298.15 + log(rt / benchBeta.Ro) / benchBeta.beta) - 273.15;
+}
+
+static double maxError(BenchCase c)
+{
+    NTCsensor &s = benchSensor(c);
+    double     e = 0.0;
+
+    for (uint32_t a = 1; a < benchAdc.Amax; a++)
+    {
+        double t = exactCelsius(c, s.getRtAt(a));
+        if (! (t >= NTC_LUT_TMIN && t <= NTC_LUT_TMAX)) continue;
+        s.add((uint16_t)a);
+        double d = fabs(s.getReading().cCelsius / 100.0 - t);
+        if (d > e) e = d;
+    }
+    return e;
+}
+
+static uint32_t dataReady;
+static void onData(void *ctx, const Reading &r) { (void)ctx; (void)r; dataReady++; }
+
+/**
+ * ns per pass of loop() which takes a sample, virtual time advances by 
+ * the refresh interval before each pass
+ */
+static double nsPerTick(uint32_t n)
+{
+    NTCthermostat t(benchBetaSensor, nullptr, nullptr, onData);
+    uint32_t      ms = 0;
+
+    halSetMillis(ms);
+    t.setRefreshInterval(1000);
+    t.enable();
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        t.loop();
+        halSetMillis(ms += 1000);
+        halAnalogValue = 300 + (i & 0x1FF);
+    }
+    double ns = nsSince(t0) / n;
+    halRealTime();
+    return ns;
+}
+
+int main()
+{
+  #ifdef NTC_FIXED_POINT
+    printf("NTCsensor backends, NTC_FIXED_POINT\n");
+  #else
+    printf("NTCsensor backends, floating point\n");
+  #endif
+    printf("%-6s %10s %12s\n", "case", "ns/conv", "max err °C");
+    for (uint8_t c = 0; c < BENCH_CASES; c++)
+    {
+        uint32_t n  = 0;
+        auto     t0 = std::chrono::steady_clock::now();
+        for (uint16_t r = 0; r < repeats; r++) n += runCase((BenchCase)c);
+        printf("%-6s %10.1f %12.3f\n", benchNames[c], nsSince(t0) / n, maxError((BenchCase)c));
+    }
+
+    const uint32_t passes = 1000000UL;
+    halSetMillis(0);                      // millis() of the board costs a few cycles only
+    auto t0 = std::chrono::steady_clock::now();
+    loopIdle(passes);
+    double nsIdle = nsSince(t0) / passes;
+    halRealTime();
+    printf("\nNTCthermostat::loop()\n");
+    printf("idle   %10.1f ns/pass\n", nsIdle);
+    printf("tick   %10.1f ns/pass\n", nsPerTick(100000UL));
+    return 0;
+}
@@ -0,0 +1,58 @@
+/**
+ * Program      halNative.cpp
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Implements the minimal Arduino HAL of bench/hal/Arduino.h
+ */
+
+#include <Arduino.h>
+#include <chrono>
+
+HardwareSerial Serial;
+uint16_t halAnalogValue = 512;
+uint16_t (*halAnalogRead)(uint8_t pin) = nullptr;
+
+static const auto tStart    = std::chrono::steady_clock::now();
+static bool       isVirtual = false;
+static uint32_t   msVirtual = 0;
+
+unsigned long micros()
+{
+    if (isVirtual) return msVirtual * 1000UL;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count();
+}
+
+unsigned long millis()
+{
+    if (isVirtual) return msVirtual;
+    return micros() / 1000UL;
+}
+
+void halSetMillis(uint32_t ms)
+{
+    isVirtual = true;
+    msVirtual = ms;
+}
+
+void halRealTime()
+{
+    isVirtual = false;
+}
+
+void delay(unsigned long ms)
+{
+    if (isVirtual) msVirtual += ms;
+    else for (unsigned long t = millis(); millis() - t < ms;) {}
+}
+
+void yield() {}
+
+int analogRead(uint8_t pin)
+{
+    return halAnalogRead != nullptr ? halAnalogRead(pin) : halAnalogValue;
+}
+
+void analogWrite(uint8_t, int) {}
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int  digitalRead(uint8_t) { return LOW; }
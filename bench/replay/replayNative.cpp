@@ -0,0 +1,127 @@
+/**
+ * Program      replayNative.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Replays a trace of NTCtrace through NTCsensor and NTCthermostat on the
+ *              host with virtual time and sweeps the limits, the hysteresis and the
+ *              EMA filter. For each combination the number of transitions of the output
+ *              and its duty cycle are reported. Without a file a synthetic week is
+ *              generated: a daily swing of ±1.5 °C around 20.5 °C with ADC noise.
+ *
+ * Build        pio run -e native_replay && .pio/build/native_replay/program [trace.bin] [msRefresh]
+ *
+ *              The trace has to be recorded with the NTC and ADC parameters below
+ *              (Elegoo module on the Uno) and replayed with the refresh interval of
+ *              the recording, 5000 ms by default.
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+#include "NTCtrace.h"
+#include "NTCthermostat.h"
+#include "NTCfilter.h"
+
+ParamsNTC ntcRs10k = { 10000, 10000, 2800, nullptr };
+ParamsADC adcUno   = { A0, true, 1023, 5000.0, 5000.0, 0.0, nullptr };
+
+static const float   limitsLow[] = { 19.5, 20.0, 20.5 };
+static const float   hysteresis[] = { 0.25, 0.5, 1.0 };
+static const uint8_t emaShifts[]  = { 0, 2, 4 };     // 0 without filter
+
+using Result = struct result { uint32_t switches; double duty; };
+
+struct VectorOut
+{
+    std::vector<uint8_t> bytes;
+    size_t write(const uint8_t *data, size_t len) { bytes.insert(bytes.end(), data, data + len); return len; }
+};
+
+/**
+ * Analog value of the Elegoo module at the temperature celsius
+ */
+static uint16_t avalAt(double celsius)
+{
+    double rt = ntcRs10k.Ro * exp(ntcRs10k.beta * (1.0 / (celsius + 273.15) - 1.0 / 298.15));
+    return (uint16_t)lround(adcUno.Amax * rt / (ntcRs10k.Rs + rt));
+}
+
+static void syntheticWeek(VectorOut &out, uint32_t msRefresh)
+{
+    TraceWriter trace(sinkOf(out));
+    trace.begin(0);
+    srand(1);
+    for (uint32_t ms = 0; ms < 7UL * 86400000UL; ms += msRefresh)
+    {
+        double t = 20.5 + 1.5 * sin(2.0 * M_PI * ms / 86400000.0);
+        trace.write(ms, avalAt(t) + rand() % 5 - 2);
+    }
+    trace.flush();
+}
+
+static Result replay(const std::vector<uint8_t> &data, uint32_t msRefresh, float low, float high, uint8_t emaShift)
+{
+    TraceReader   reader(data.data(), data.size());
+    TraceReplay   source(reader);
+    NTCsensor     sensor(ntcRs10k, adcUno);
+    NTCthermostat thermostat(sensor, nullptr, nullptr, nullptr);
+    EmaFilter     ema(emaShift);
+    uint32_t      now  = reader.getStart();
+    uint32_t      msOn = 0;
+
+    sensor.useSource(source);
+    if (emaShift > 0) thermostat.setFilter(ema.stage());
+    thermostat.setLimitLow(low);
+    thermostat.setLimitHigh(high);
+    thermostat.setRefreshInterval(msRefresh);
+    halSetMillis(now);
+    thermostat.enable();
+    while (reader.available())
+    {
+        thermostat.loop();
+        uint32_t due  = thermostat.msUntilDue(now);
+        uint32_t next = now + (due > 0 ? due : 1);
+        uint32_t rec  = reader.msNext();
+        if ((int32_t)(rec - now) > 0 && (due == 0 || (int32_t)(rec - next) < 0)) next = rec;  // waiting for conversions
+        if (thermostat.isOutputOn()) msOn += next - now;
+        now = next;
+        halSetMillis(now);
+    }
+    halRealTime();
+    return { thermostat.getSwitchCount(), 100.0 * msOn / (now - reader.getStart() + 1) };
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t  msRefresh = argc > 2 ? strtoul(argv[2], nullptr, 10) : 5000;
+    VectorOut trace;
+
+    if (argc > 1)
+    {
+        FILE *f = fopen(argv[1], "rb");
+        if (f == nullptr) { perror(argv[1]); return 1; }
+        uint8_t buf[4096];
+        size_t  n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) trace.write(buf, n);
+        fclose(f);
+    }
+    else syntheticWeek(trace, msRefresh);
+    if (! TraceReader(trace.bytes.data(), trace.bytes.size()).isValid()) { fprintf(stderr, "no trace\n"); return 1; }
+
+    printf("%zu bytes, refresh %u ms\n", trace.bytes.size(), (unsigned)msRefresh);
+    printf("%6s %6s %4s %9s %7s\n", "low", "high", "ema", "switches", "duty %");
+    auto t0 = std::chrono::steady_clock::now();
+    uint16_t runs = 0;
+    for (float low : limitsLow)
+        for (float h : hysteresis)
+            for (uint8_t shift : emaShifts)
+            {
+                Result r = replay(trace.bytes, msRefresh, low, low + h, shift);
+                printf("%6.2f %6.2f %4u %9u %7.1f\n", low, low + h, shift, (unsigned)r.switches, r.duty);
+                runs++;
+            }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("%u replays in %.2f s\n", runs, s);
+    return 0;
+}
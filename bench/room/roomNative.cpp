@@ -0,0 +1,120 @@
+/**
+ * Program      roomNative.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Closed loop simulation of a room with a lagged heater on the host. The
+ *              heater warms a wall which warms the room, so the room keeps warming after
+ *              switch off. NTCsensor reads the room through the HAL, NTCthermostat
+ *              switches the heater, the time is virtual. The cases compare the fixed
+ *              refresh interval with the anticipator of NTCanticipator and with the
+ *              adaptive interval of 1 .. 60 s, also with minimum on and off times. For
+ *              each case the number of samples and transitions and the range of the room
+ *              after the settling time are printed.
+ *
+ * Model        wall += (3 K * heat - (wall - room)) * dt / 180 s
+ *              room += (0.5 * (wall - room) - 0.02 * (room - 15 °C)) * dt / 600 s
+ *              integrated in steps of 1 s, heat 0 or 1
+ *
+ * Build        pio run -e native_room && .pio/build/native_room/program
+ */
+
+#include <Arduino.h>
+#include "NTCthermostat.h"
+#include "NTCanticipator.h"
+
+ParamsNTC ntcRs10k = { 10000, 10000, 2800, nullptr };
+ParamsADC adcUno   = { A0, true, 1023, 5000.0, 5000.0, 0.0, nullptr };
+
+using RoomCase = struct roomCase { const char *name; float low; float high; uint32_t hours; uint32_t msMin; bool anticipate; bool adaptive; };
+using Result   = struct result { uint32_t samples; uint32_t switches; double cMin; double cMax; uint32_t msLag; };
+
+static const RoomCase cases[] =
+{
+    { "5 s",                        20.0, 21.0, 24,      0, false, false },
+    { "5 s anticipator",            20.0, 21.0, 24,      0, true,  false },
+    { "5 s",                        20.0, 20.5,  8,      0, false, false },
+    { "1 .. 60 s",                  20.0, 20.5,  8,      0, false, true  },
+    { "1 .. 60 s anticipator",      20.0, 20.5,  8,      0, true,  true  },
+    { "5 s min. 10 min",            20.0, 20.5,  8, 600000, false, false },
+    { "1 .. 60 s min. 10 min",      20.0, 20.5,  8, 600000, false, true  },
+};
+
+static const uint32_t msSettle = 2UL * 3600000UL;   // the range is taken after it
+
+static double room;
+static double wall;
+
+/**
+ * Analog value of the Elegoo module at the temperature of the room
+ */
+static uint16_t avalOfRoom(uint8_t)
+{
+    double rt = ntcRs10k.Ro * exp(ntcRs10k.beta * (1.0 / (room + 273.15) - 1.0 / 298.15));
+    return (uint16_t)lround(adcUno.Amax * rt / (ntcRs10k.Rs + rt));
+}
+
+static uint32_t samples;
+static void countSample(void *ctx, const Reading &reading) { (void)ctx; (void)reading; samples++; }
+
+static Result simulate(const RoomCase &c)
+{
+    NTCsensor      sensor(ntcRs10k, adcUno);
+    NTCthermostat  thermostat(sensor, nullptr, nullptr, countSample);
+    NTCanticipator anticipator(16);
+    SlopeEstimator slope(8);
+    Result   result  = { 0, 0, 100.0, -100.0, 0 };
+    uint32_t now     = 0;
+    uint32_t msModel = 0;                           // next step of the model
+    uint32_t msEnd   = c.hours * 3600000UL;
+
+    room = wall = 19.5;
+    samples     = 0;
+    thermostat.setLimitLow(c.low);
+    thermostat.setLimitHigh(c.high);
+    thermostat.setRefreshInterval(5000);
+    thermostat.setMinOnTime(c.msMin);
+    thermostat.setMinOffTime(c.msMin);
+    if (c.anticipate) thermostat.useAnticipator(anticipator);
+    if (c.adaptive)   thermostat.useAdaptiveInterval(slope, 1000, 60000);
+    halSetMillis(now);
+    thermostat.enable();
+    while (now < msEnd)
+    {
+        thermostat.loop();
+        if (now == msModel)
+        {
+            double heat = thermostat.isOutputOn() ? 1.0 : 0.0;
+            wall += (3.0 * heat - (wall - room)) / 180.0;
+            room += (0.5 * (wall - room) - 0.02 * (room - 15.0)) / 600.0;
+            msModel += 1000;
+            if (now >= msSettle)
+            {
+                if (room < result.cMin) result.cMin = room;
+                if (room > result.cMax) result.cMax = room;
+            }
+        }
+        uint32_t due  = thermostat.msUntilDue(now);
+        uint32_t next = now + (due > 0 ? due : 1);
+        if ((int32_t)(next - msModel) > 0) next = msModel;
+        now = next;
+        halSetMillis(now);
+    }
+    halRealTime();
+    result.samples  = samples;
+    result.switches = thermostat.getSwitchCount();
+    result.msLag    = c.anticipate ? anticipator.getLag() : 0;
+    return result;
+}
+
+int main()
+{
+    halAnalogRead = avalOfRoom;
+    printf("%-24s %6s %6s %5s %8s %9s %7s %7s %6s\n", "case", "low", "high", "h", "samples", "switches", "min °C", "max °C", "lag s");
+    for (const RoomCase &c : cases)
+    {
+        Result r = simulate(c);
+        printf("%-24s %6.2f %6.2f %5u %8u %9u %7.2f %7.2f %6u\n", c.name, c.low, c.high, (unsigned)c.hours,
+               (unsigned)r.samples, (unsigned)r.switches, r.cMin, r.cMax, (unsigned)(r.msLag / 1000));
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * Program      benchTarget.cpp
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Benchmark sketch which counts the CPU cycles of the conversion backends 
+ *              of NTCsensor and of an idle pass of NTCthermostat::loop() on the board.
+ * 
+ *              Arduino uno   Timer1 without prescaler, overflows counted in its ISR
+ *              ESP32/ESP8266 cycle counter ccount (ESP.getCycleCount())
+ * 
+ *              The counts include the interrupts of the core, e.g. timer0 of millis().
+ *              The results are printed once after reset.
+ * 
+ *              On the ESP32 it checks further that each switch of the range of the 
+ *              auto-ranging installs the curve of NTCcalibration::characterizeAdc() 
+ *              for the attenuation of the range.
+ * 
+ * Build        pio run -e bench_uno -t upload && pio device monitor -e bench_uno
+ *              pio run -e bench_esp32 -t upload && pio device monitor -e bench_esp32
+ */
+
+#include "benchCases.h"
+#ifdef ESP32
+  #include "NTCcalibration.h"
+#endif
+
+#if defined(__AVR__)
+  #include <avr/interrupt.h>
+  static volatile uint16_t t1Overflows;
+  ISR(TIMER1_OVF_vect) { t1Overflows++; }
+
+  static void cyclesStart()
+  {
+      noInterrupts();
+      TCCR1A = 0;
+      TCCR1B = 0;
+      TCNT1  = 0;
+      t1Overflows = 0;
+      TIFR1  = 1 << TOV1;
+      TIMSK1 = 1 << TOIE1;
+      TCCR1B = 1 << CS10;                   // clk/1
+      interrupts();
+  }
+
+  static uint32_t cyclesStop()
+  {
+      noInterrupts();
+      uint16_t lo = TCNT1;
+      uint16_t hi = t1Overflows;
+      if ((TIFR1 & (1 << TOV1)) && lo < 0x8000) hi++;  // overflow not yet serviced
+      TCCR1B = 0;
+      TIMSK1 = 0;
+      interrupts();
+      return ((uint32_t)hi << 16) | lo;
+  }
+#else
+  static uint32_t ccount0;
+  static void     cyclesStart() { ccount0 = ESP.getCycleCount(); }
+  static uint32_t cyclesStop()  { return ESP.getCycleCount() - ccount0; }
+#endif
+
+static void printResult(const char *name, uint32_t cycles, uint32_t n)
+{
+    uint32_t perOp = (cycles + n / 2) / n;
+    uint32_t ns    = (uint32_t)((uint64_t)cycles * 1000000000ULL / F_CPU / n);
+
+    Serial.print(name);
+    Serial.print("\t");
+    Serial.print(perOp);
+    Serial.print(" cycles\t");
+    Serial.print(ns);
+    Serial.println(" ns");
+}
+
+#ifdef ESP32
+  static ParamsADC adcRange0   = { A0, true, 4095, ADC_0db,   3300.0, 1100.0,  65.0, nullptr };
+  static ParamsADC adcRange2_5 = { A0, true, 4095, ADC_2_5db, 3300.0, 1300.0,  65.0, nullptr };
+  static ParamsADC adcRange6   = { A0, true, 4095, ADC_6db,   3300.0, 1800.0,  90.0, nullptr };
+  static ParamsADC adcRange11  = { A0, true, 4095, ADC_11db,  3300.0, 3200.0, 130.0, nullptr };
+  static ParamsADC *const adcRanges[] = { &adcRange0, &adcRange2_5, &adcRange6, &adcRange11 };
+
+  /**
+   * useAutoRange() with the first r + 1 ranges applies range r, 
+   * its curve and factor must be the ones of characterizeAdc()
+   */
+  static void checkRanges()
+  {
+      ParamsADC      adc = adcRange11;
+      NTCsensor      sensor(benchBeta, adc);
+      NTCcalibration cal(sensor);
+
+      sensor.useAutoRange(adcRanges, 4);
+      if (! cal.characterizeAdc())
+      {
+          Serial.println("ranges\tno eFuse calibration");
+          return;
+      }
+      for (uint8_t r = 0; r < 4; r++)
+      {
+          const ParamsADC &range = *adcRanges[r];
+          sensor.useAutoRange(adcRanges, r + 1);
+          const AdcCurve  *curve = sensor.getAdcCurve();
+          bool ok = curve != nullptr && curve->mv[0] == (uint16_t)lround(range.Voff) && curve->mv[NTC_ADC_KNOTS] == (uint16_t)lround(range.Vref)
+                 && fabs(sensor.getFactorV() - (range.Vref - range.Voff) / range.Amax) < 1e-9;
+          Serial.print("range ");
+          Serial.print(r);
+          Serial.println(ok ? "\tok" : "\tFAIL");
+      }
+      Serial.print("ranges\tmax. error of the curves ");
+      Serial.print(cal.getAdcFitError());
+      Serial.println(" mV");
+  }
+#endif
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(500);
+  #ifdef NTC_FIXED_POINT
+    Serial.println("NTCsensor backends, NTC_FIXED_POINT");
+  #else
+    Serial.println("NTCsensor backends, floating point");
+  #endif
+    for (uint8_t c = 0; c < BENCH_CASES; c++)
+    {
+        benchSensor((BenchCase)c);            // builds the table outside the measurement
+        cyclesStart();
+        uint32_t n = runCase((BenchCase)c);
+        printResult(benchNames[c], cyclesStop(), n);
+    }
+
+    const uint32_t passes = 10000UL;
+    cyclesStart();
+    loopIdle(passes);
+    printResult("loop idle", cyclesStop(), passes);
+  #ifdef ESP32
+    checkRanges();
+  #endif
+}
+
+void loop()
+{
+}
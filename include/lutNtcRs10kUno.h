@@ -0,0 +1,26 @@
+/**
+ * Header       lutNtcRs10kUno.h
+ * 
+ * Purpose      Lookup table for NTCsensor generated by tools/ntc_lut.py
+ *              Rs 10000, Ro 10000, BETA 2800, NTC to GND
+ *              Amax 1023, Vcc 5000 mV, Vref 5000 mV, Voff 0 mV
+ *              65 entries, h = 16, max. error 0.306 °C in -40 .. 125 °C
+ */
+#ifndef _LUTNTCRS10KUNO_H_
+#define _LUTNTCRS10KUNO_H_
+#include "NTCsensor.h"
+
+const int16_t lutNtcRs10kUnoTable[65] PROGMEM = {
+     32767,  26027,  19679,  16572,  14575,  13123,  11991,  11066,
+     10287,   9613,   9020,   8490,   8011,   7573,   7170,   6795,
+      6445,   6115,   5804,   5509,   5227,   4958,   4699,   4450,
+      4209,   3976,   3750,   3529,   3314,   3103,   2897,   2694,
+      2494,   2297,   2101,   1908,   1716,   1525,   1335,   1145,
+       954,    763,    571,    378,    182,    -16,   -217,   -423,
+      -633,   -848,  -1070,  -1300,  -1539,  -1789,  -2053,  -2334,
+     -2635,  -2962,  -3323,  -3730,  -4203,  -4779,  -5537,  -6725,
+    -27315
+};
+const LutNTC lutNtcRs10kUno = { lutNtcRs10kUnoTable, 65, 4, true };
+
+#endif
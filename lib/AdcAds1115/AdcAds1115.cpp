@@ -0,0 +1,225 @@
+/**
+ * Class        AdcAds1115.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class AdcAds1115, see AdcAds1115.h
+ *
+ * Registers    0 conversion   result, ADS1015 left aligned (12 bit << 4)
+ *              1 config       OS | MUX | PGA | MODE | DR | COMP_MODE | COMP_POL | COMP_LAT | COMP_QUE
+ *                             15   14:12  11:9   8    7:5     4          3          2        1:0
+ *              2 Lo_thresh    MSB = 0 \  with COMP_QUE = 00 the ALERT/RDY pin signals
+ *              3 Hi_thresh    MSB = 1 /  the end of each conversion
+ *
+ *              Single shot mode: writing OS = 1 starts one conversion of the channel
+ *              selected by MUX, afterwards the chip powers down.
+ *
+ * Board        Arduino UNO R3, Wemos D1 R2, ESP32 DevKit V1
+ */
+
+#include "AdcAds1115.h"
+
+#define ADS_REG_CONVERSION  0
+#define ADS_REG_CONFIG      1
+#define ADS_REG_LO_THRESH   2
+#define ADS_REG_HI_THRESH   3
+
+#define ADS_OS_START        0x8000
+#define ADS_MUX_SINGLE      0x4000    // AINx against GND, x in bits 13:12
+#define ADS_MODE_SINGLE     0x0100
+#define ADS_COMP_RDY        0x0000    // assert ALERT/RDY after one conversion
+#define ADS_COMP_DISABLE    0x0003
+
+// samples per second of the data rates 0..7
+static const uint16_t spsAds1115[8] = {   8,  16,  32,  64,  128,  250,  475,  860 };
+static const uint16_t spsAds1015[8] = { 128, 250, 490, 920, 1600, 2400, 3300, 3300 };
+
+// full scale in mV of the ranges
+static const uint16_t mvRange[6] = { 6144, 4096, 2048, 1024, 512, 256 };
+
+/**
+ * Set up the chip and start the conversion of the first channel
+ * in channelMask. Without pinRdy the conversion time is waited for.
+ */
+void AdcAds1115::begin(uint8_t channelMask, int8_t pinRdy, AdsRange range, uint8_t dataRate)
+{
+    _mask   = channelMask & 0x0F;
+    _pinRdy = pinRdy;
+    _fresh  = 0;
+    if (_reference >= 0) _mask |= 1 << _reference;
+    if (_mask == 0) return;
+
+    dataRate &= 0x07;
+    uint16_t sps  = _chip == ADS1115 ? spsAds1115[dataRate] : spsAds1015[dataRate];
+    _usConversion = 1100000UL / sps + 50;                       // oscillator ±10 %, wakeup
+    _range  = range;
+    _config = ADS_MUX_SINGLE | ADS_MODE_SINGLE | ((uint16_t)dataRate << 5)
+            | (_pinRdy >= 0 ? ADS_COMP_RDY : ADS_COMP_DISABLE);
+    _setRange();
+
+    Wire.begin();
+    if (_pinRdy >= 0)
+    {
+        pinMode(_pinRdy, INPUT_PULLUP);
+        _writeRegister(ADS_REG_LO_THRESH, 0x0000);
+        _writeRegister(ADS_REG_HI_THRESH, 0x8000);
+    }
+    _start(_next(ADS_CHANNELS - 1));
+}
+
+void AdcAds1115::end()
+{
+    _channel = -1;
+}
+
+/**
+ * Collect the result of the conversion in progress if it is finished and
+ * start the next channel. Returns at once if the conversion is still running.
+ */
+void AdcAds1115::loop()
+{
+    int16_t value;
+
+    if (_channel < 0) return;
+    if (! _isRunning)                                           // the start failed
+    {
+        _start(_channel);
+        return;
+    }
+    if (! _isDone()) return;
+    uint8_t channel = _channel;
+    if (_readRegister(ADS_REG_CONVERSION, value))
+    {
+        _raw[channel] = value;
+        _fresh |= 1 << channel;
+        _conversions++;
+    }
+    _start(_next(channel));
+}
+
+/**
+ * mvReference is the voltage at the reference channel, the FSR
+ * is widened to it with the next conversion
+ */
+void AdcAds1115::setReference(int8_t channel, uint16_t mvReference)
+{
+    _reference   = channel < ADS_CHANNELS ? channel : -1;
+    _mvReference = mvReference;
+    if (_reference >= 0) _mask |= 1 << _reference;
+    _setRange();
+}
+
+/**
+ * The FSR of begin(), with a reference at least its voltage
+ */
+AdsRange AdcAds1115::getRange()
+{
+    uint8_t range = _range;
+    if (_reference >= 0)
+    {
+        while (range > ADS_FSR_6144 && mvRange[range] < _mvReference) range--;
+    }
+    return (AdsRange)range;
+}
+
+void AdcAds1115::_setRange()
+{
+    _config = (_config & ~0x0E00) | ((uint16_t)getRange() << 9);
+}
+
+/**
+ * Latest value of the channel, scaled to ADS_AMAX. With a reference
+ * channel the value is the ratio to it, false while the reference 
+ * is not measured or at full scale. Negative results (offset near 
+ * GND) are clipped to 0.
+ */
+bool AdcAds1115::read(uint8_t channel, uint16_t &aval)
+{
+    if (channel >= ADS_CHANNELS || ! (_fresh & (1 << channel))) return false;
+    _fresh &= ~(1 << channel);
+
+    int32_t value = _raw[channel] > 0 ? _raw[channel] : 0;
+    if (_reference >= 0)
+    {
+        int32_t ref = _raw[_reference];
+        if (ref <= 0) return false;                             // reference not measured yet
+        if (ref >= ADS_CLIPPED) return false;                   // reference clipped, the FSR is too small
+        value = (value * ADS_AMAX + ref / 2) / ref;
+    }
+    aval = value > ADS_AMAX ? ADS_AMAX : value;
+    return true;
+}
+
+int16_t AdcAds1115::getRaw(uint8_t channel)
+{
+    return channel < ADS_CHANNELS ? _raw[channel] : 0;
+}
+
+AdcAds1115::Channel AdcAds1115::channel(uint8_t channel)
+{
+    return Channel(*this, channel);
+}
+
+uint32_t AdcAds1115::getConversions()
+{
+    return _conversions;
+}
+
+uint32_t AdcAds1115::getErrors()
+{
+    return _errors;
+}
+
+/**
+ * ALERT/RDY is low when the conversion is finished
+ */
+bool AdcAds1115::_isDone()
+{
+    if (_pinRdy >= 0) return digitalRead(_pinRdy) == LOW;
+    return micros() - _usStart >= _usConversion;
+}
+
+void AdcAds1115::_start(uint8_t channel)
+{
+    _channel   = channel;
+    _usStart   = micros();
+    _isRunning = _writeRegister(ADS_REG_CONFIG, ADS_OS_START | _config | ((uint16_t)channel << 12));
+}
+
+/**
+ * Next channel of the mask after channel, round-robin
+ */
+uint8_t AdcAds1115::_next(uint8_t channel)
+{
+    for (uint8_t i = 1; i <= ADS_CHANNELS; i++)
+    {
+        uint8_t c = (channel + i) % ADS_CHANNELS;
+        if (_mask & (1 << c)) return c;
+    }
+    return channel;
+}
+
+bool AdcAds1115::_writeRegister(uint8_t reg, uint16_t value)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(reg);
+    Wire.write((uint8_t)(value >> 8));
+    Wire.write((uint8_t)value);
+    if (Wire.endTransmission() == 0) return true;
+    _errors++;
+    return false;
+}
+
+bool AdcAds1115::_readRegister(uint8_t reg, int16_t &value)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(reg);
+    if (Wire.endTransmission() != 0 || Wire.requestFrom(_address, (uint8_t)2) != 2)
+    {
+        _errors++;
+        return false;
+    }
+    uint8_t msb = Wire.read();
+    uint8_t lsb = Wire.read();
+    value = (int16_t)((uint16_t)msb << 8 | lsb);
+    return true;
+}
@@ -0,0 +1,109 @@
+/**
+ * Header       AdcAds1115.h
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Declaration of the class AdcAds1115. An ADS1115 (16 bit) or ADS1015 (12 bit)
+ *              on the I2C bus converts the channels of its channel mask one after the other.
+ *              loop() never waits for a conversion: it checks the ALERT/RDY pin (or the
+ *              conversion time if no pin is connected), fetches the finished result and
+ *              immediately starts the conversion of the next channel. The latest result of
+ *              each channel is kept until NTCsensor reads it.
+ *
+ * Usage        AdcAds1115 ads;
+ *              ParamsADC adcAds = { 0, true, ADS_AMAX, 5000.0, 5000.0, 0.0 };  // channel 0
+ *              AdcAds1115::Channel ads0 = ads.channel(0);
+ *              ads.setReference(3, 5000);         // AIN3 connected to Vcc = 5 V of the dividers
+ *              ads.begin(0x0F, 2, ADS_FSR_6144);  // AIN0..AIN3, ALERT/RDY on pin 2, ±6.144 V > Vcc
+ *              loop() { ads.loop(); if (ntcSensor.update(ads0)) ... }
+ *
+ * Ratiometric  The ADS1x15 measures against its internal reference, not against Vcc. Is
+ *              a channel connected to the supply of the voltage dividers, setReference()
+ *              divides each result by the latest result of that channel and scales it to
+ *              ADS_AMAX. A drift of Vcc then cancels like with the ADC of the Uno, Vref
+ *              and Vcc in ParamsADC are both the nominal Vcc. Without reference the values
+ *              are scaled to the full scale range, Vref in ParamsADC is then the FSR in mV
+ *              (e.g. 4096.0 for ADS_FSR_4096).
+ *              The reference channel must not clip: with a reference the FSR is widened to
+ *              at least the mV of setReference(), e.g. ADS_FSR_6144 at 5 V, see getRange().
+ *              read() rejects the values while the reference is at full scale.
+ *
+ * Remarks      The ALERT/RDY pin is set up as conversion ready output, it is pulled low
+ *              at the end of a conversion and released when the next one is started. It
+ *              needs a pull-up, INPUT_PULLUP is used. At 860 SPS a channel takes 1.2 ms,
+ *              four channels are refreshed every 4.7 ms. One transfer on the I2C bus at
+ *              400 kHz takes about 100 µs, call Wire.setClock(400000) after begin().
+ */
+#ifndef _ADCADS1115_H_
+#define _ADCADS1115_H_
+#include <Arduino.h>
+#include <Wire.h>
+#include "NTCsensor.h"
+
+#define ADS_CHANNELS  4
+#define ADS_AMAX      32767     // Amax of ParamsADC, full scale of both chips
+#define ADS_CLIPPED   0x7FF0    // results from here on are at full scale (ADS1015 left aligned)
+
+enum AdsChip  { ADS1115, ADS1015 };
+enum AdsRange { ADS_FSR_6144, ADS_FSR_4096, ADS_FSR_2048, ADS_FSR_1024, ADS_FSR_512, ADS_FSR_256 };  // ± mV
+
+class AdcAds1115
+{
+    public:
+        /**
+         * ADC policy for NTCsensor::update(adc), one per channel
+         */
+        class Channel
+        {
+            public:
+                Channel(AdcAds1115 &ads, uint8_t channel) : _ads(ads), _channel(channel) {}
+
+                static const bool isBuffered = true;
+
+                void begin() {}
+                bool read(uint16_t &aval) { return _ads.read(_channel, aval); }
+
+            private:
+                AdcAds1115 &_ads;
+                uint8_t     _channel;
+        };
+
+        AdcAds1115(AdsChip chip = ADS1115, uint8_t address = 0x48) : _chip(chip), _address(address) {}
+
+        void     begin(uint8_t channelMask = 0x0F, int8_t pinRdy = -1, AdsRange range = ADS_FSR_4096, uint8_t dataRate = 7);
+        void     end();
+        void     loop();                              // collect a finished conversion and start the next one
+        void     setReference(int8_t channel, uint16_t mvReference = 5000);  // channel at Vcc of the dividers, -1 for none
+        AdsRange getRange();                          // FSR in use, at least the reference
+        bool     read(uint8_t channel, uint16_t &aval);  // latest value, false if not newer than the last one read
+        int16_t  getRaw(uint8_t channel);             // latest result, 16 bit scale
+        Channel  channel(uint8_t channel);            // policy for NTCsensor::update()
+        uint32_t getConversions();
+        uint32_t getErrors();                          // failed I2C transfers
+
+    private:
+        AdsChip  _chip;
+        uint8_t  _address;
+        uint8_t  _mask       = 0;
+        int8_t   _pinRdy     = -1;
+        int8_t   _reference  = -1;
+        int8_t   _channel    = -1;    // conversion in progress, -1 if stopped
+        bool     _isRunning  = false; // false if the start of the conversion failed
+        AdsRange _range      = ADS_FSR_4096;  // FSR of begin()
+        uint16_t _mvReference = 0;    // voltage at the reference channel
+        uint16_t _config     = 0;     // config register without OS and MUX
+        uint32_t _usConversion = 0;   // conversion time incl. tolerance of the oscillator
+        uint32_t _usStart    = 0;
+        int16_t  _raw[ADS_CHANNELS] = {};
+        uint8_t  _fresh      = 0;     // channels with a result not read yet
+        uint32_t _conversions = 0;
+        uint32_t _errors     = 0;
+
+        void     _setRange();
+        bool     _isDone();
+        void     _start(uint8_t channel);
+        uint8_t  _next(uint8_t channel);
+        bool     _writeRegister(uint8_t reg, uint16_t value);
+        bool     _readRegister(uint8_t reg, int16_t &value);
+};
+
+#endif
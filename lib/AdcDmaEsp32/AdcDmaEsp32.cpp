@@ -0,0 +1,134 @@
+/**
+ * Class        AdcDmaEsp32.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class AdcDmaEsp32. The ADC1 runs continuously at the 
+ *              given sample rate, the DMA writes the results into a ring of buffers.
+ *              _fill() copies what is ready without blocking (timeout 0), so the
+ *              loop never waits for a conversion.
+ * 
+ * Board        ESP32 DevKit V1
+ * 
+ **/
+
+#include "AdcDmaEsp32.h"
+
+#ifdef ESP32
+
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+/**
+ * Arduino core 3.x, ADC continuous driver
+ */
+bool AdcDmaEsp32::begin(uint8_t pin, adc_attenuation_t att, uint32_t sampleRate, uint32_t conversionsPerPin)
+{
+    const uint8_t pins[] = { pin };
+
+    analogContinuousSetAtten(att);
+    analogContinuousSetWidth(12);
+    if (! analogContinuous(pins, 1, conversionsPerPin, sampleRate, nullptr)) return false;
+    _running = analogContinuousStart();
+    return _running;
+}
+
+void AdcDmaEsp32::end()
+{
+    if (! _running) return;
+    analogContinuousStop();
+    analogContinuousDeinit();
+    _running = false;
+}
+
+bool AdcDmaEsp32::_fill()
+{
+    adc_continuous_data_t *result = nullptr;
+
+    if (! _running || ! analogContinuousRead(&result, 0)) return false;
+    _buf[0] = (uint16_t)result[0].avg_read_raw;
+    _count  = 1;
+    _pos    = 0;
+    return true;
+}
+
+#else
+#include <driver/i2s.h>
+#include <driver/adc.h>
+
+/**
+ * Arduino core 2.x, I2S0 in built-in ADC mode
+ */
+bool AdcDmaEsp32::begin(uint8_t pin, adc_attenuation_t att, uint32_t sampleRate, uint32_t conversionsPerPin)
+{
+    (void)conversionsPerPin;                                   // every conversion is delivered
+    int8_t channel = digitalPinToAnalogChannel(pin);
+    if (channel < 0 || channel > 7) return false;              // ADC1 only
+
+    i2s_config_t cfg = {};
+    cfg.mode                 = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    cfg.sample_rate          = sampleRate;
+    cfg.bits_per_sample      = I2S_BITS_PER_SAMPLE_16BIT;
+    cfg.channel_format       = I2S_CHANNEL_FMT_ONLY_LEFT;
+    cfg.communication_format = I2S_COMM_FORMAT_STAND_MSB;
+    cfg.dma_buf_count        = 4;
+    cfg.dma_buf_len          = ADC_DMA_BUF_LEN;
+    cfg.use_apll             = false;
+
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten((adc1_channel_t)channel, (adc_atten_t)att);
+    if (i2s_driver_install(I2S_NUM_0, &cfg, 4, &_events) != ESP_OK) return false;
+    i2s_set_adc_mode(ADC_UNIT_1, (adc1_channel_t)channel);
+    _running = i2s_adc_enable(I2S_NUM_0) == ESP_OK;
+    return _running;
+}
+
+void AdcDmaEsp32::end()
+{
+    if (! _running) return;
+    i2s_adc_disable(I2S_NUM_0);
+    i2s_driver_uninstall(I2S_NUM_0);
+    _running = false;
+}
+
+bool AdcDmaEsp32::_fill()
+{
+    size_t      bytesRead = 0;
+    i2s_event_t event;
+
+    if (! _running) return false;
+    while (xQueueReceive((QueueHandle_t)_events, &event, 0) == pdTRUE)
+    {
+        if (event.type == I2S_EVENT_RX_Q_OVF) _overruns++;
+    }
+    i2s_read(I2S_NUM_0, _buf, sizeof(_buf), &bytesRead, 0);   // timeout 0, never blocks
+    _count = bytesRead / sizeof(_buf[0]);
+    _pos   = 0;
+    return _count > 0;
+}
+#endif
+
+/**
+ * Next converted value. The upper 4 bits carry the channel 
+ * number in I2S mode and are masked.
+ */
+bool AdcDmaEsp32::read(uint16_t &aval)
+{
+    if (_pos >= _count && ! _fill()) return false;
+    aval = _buf[_pos++] & 0x0FFF;
+    return true;
+}
+
+AdcSource AdcDmaEsp32::source()
+{
+    return { _read, this, true };
+}
+
+uint32_t AdcDmaEsp32::getOverruns()
+{
+    return _overruns;
+}
+
+bool AdcDmaEsp32::_read(void *ctx, uint16_t &aval)
+{
+    return static_cast<AdcDmaEsp32 *>(ctx)->read(aval);
+}
+
+#endif
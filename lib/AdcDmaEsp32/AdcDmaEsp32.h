@@ -0,0 +1,54 @@
+/**
+ * Header       AdcDmaEsp32.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration of the class AdcDmaEsp32, a background acquisition of the 
+ *              ESP32 ADC1. The ADC converts continuously and the DMA fills a ring of 
+ *              buffers without using the CPU. read() returns the converted values 
+ *              without ever waiting for the ADC.
+ * 
+ *              Arduino core 2.x: I2S in built-in ADC mode (legacy I2S driver)
+ *              Arduino core 3.x: ADC continuous driver (analogContinuous), which
+ *                                delivers the mean of conversionsPerPin conversions
+ * 
+ * Usage        AdcDmaEsp32 adcDma;
+ *              adcDma.begin(A6, ADC_11db, 20000);    // 20 kHz
+ *              ntcSensor.setSource(adcDma.source());
+ * 
+ * Remarks      Only ADC1 pins (GPIO 32..39) can be used. Combined with oversampling
+ *              (ParamsADC.ovs) a sample is the mean of many conversions at no CPU cost.
+ */
+#ifndef _ADCDMAESP32_H_
+#define _ADCDMAESP32_H_
+#include <Arduino.h>
+#include "NTCsensor.h"
+
+#ifdef ESP32
+
+#ifndef ADC_DMA_BUF_LEN
+  #define ADC_DMA_BUF_LEN 64       // conversions per DMA buffer
+#endif
+
+class AdcDmaEsp32
+{
+    public:
+        bool begin(uint8_t pin, adc_attenuation_t att, uint32_t sampleRate = 20000, uint32_t conversionsPerPin = 1);
+        void end();
+        bool read(uint16_t &aval);       // next conversion, false if none is available
+        AdcSource source();              // source for NTCsensor::setSource()
+        uint32_t getOverruns();          // DMA buffers lost because they were not read in time (core 2.x)
+
+    private:
+        uint16_t _buf[ADC_DMA_BUF_LEN];
+        uint16_t _count   = 0;           // conversions in _buf
+        uint16_t _pos     = 0;           // next conversion to return
+        bool     _running = false;
+        uint32_t _overruns = 0;
+        void    *_events   = nullptr;    // I2S event queue (core 2.x)
+
+        bool     _fill();                // copy the converted values out of the DMA ring
+        static bool _read(void *ctx, uint16_t &aval);
+};
+
+#endif
+#endif
@@ -0,0 +1,127 @@
+/**
+ * Class        AdcFreeRunAvr.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class AdcFreeRunAvr, an interrupt driven acquisition
+ *              of one analog input with a double buffered accumulator. 
+ * 
+ * Board        Arduino uno
+ * 
+ **/
+
+#include "AdcFreeRunAvr.h"
+
+#ifdef __AVR__
+#include <avr/interrupt.h>
+
+AdcFreeRunAvr *AdcFreeRunAvr::_instance = nullptr;
+
+ISR(ADC_vect)
+{
+    AdcFreeRunAvr::isr();
+}
+
+/**
+ * Start the free-running mode on pin
+ */
+void AdcFreeRunAvr::begin(uint8_t pin, uint16_t blockSize)
+{
+    uint8_t channel = pin >= A0 ? pin - A0 : pin;
+
+    _instance  = this;
+    _blockSize = blockSize > 0 ? blockSize : 1;
+    _acc       = { 0, 0, 0xFFFF, 0 };
+    _seq       = 0;
+    _seqRead   = 0;
+
+    DIDR0  |= (1 << (channel & 0x07));                        // disable the digital input buffer
+    ADMUX   = (1 << REFS0) | (channel & 0x07);                 // AVcc reference, right adjusted
+    ADCSRB  = 0;                                               // free-running trigger
+    ADCSRA  = (1 << ADEN) | (1 << ADATE) | (1 << ADIE)
+            | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);      // prescaler 128
+    ADCSRA |= (1 << ADSC);                                     // start the first conversion
+}
+
+void AdcFreeRunAvr::end()
+{
+    ADCSRA &= ~((1 << ADATE) | (1 << ADIE));                   // back to single conversions for analogRead()
+    _instance = nullptr;
+}
+
+void AdcFreeRunAvr::isr()
+{
+    if (_instance != nullptr) _instance->_accumulate(ADC);
+}
+
+/**
+ * Called by the interrupt. The completed block goes into the buffer 
+ * which is not the latest one, then the sequence is incremented.
+ */
+void AdcFreeRunAvr::_accumulate(uint16_t aval)
+{
+    _acc.sum += aval;
+    if (aval < _acc.min) _acc.min = aval;
+    if (aval > _acc.max) _acc.max = aval;
+    if (++_acc.count < _blockSize) return;
+
+    uint32_t seq = _seq + 1;
+    _buf[seq & 1] = _acc;
+    asm volatile("" ::: "memory");                             // the block is written before the sequence
+    _seq = seq;
+    _acc = { 0, 0, 0xFFFF, 0 };
+}
+
+/**
+ * Copy the latest block. Repeats when the interrupt completed another 
+ * block during the copy, so the block is never torn.
+ */
+bool AdcFreeRunAvr::readBlock(AdcBlock &block)
+{
+    uint32_t seq;
+
+    do
+    {
+        seq   = _seq;
+        asm volatile("" ::: "memory");
+        block = _buf[seq & 1];
+        asm volatile("" ::: "memory");
+    } while (seq != _seq);
+
+    if (seq == _seqRead) return false;
+    if (seq - _seqRead > 1) _lost += seq - _seqRead - 1;
+    _seqRead = seq;
+    return seq != 0;
+}
+
+bool AdcFreeRunAvr::read(uint16_t &aval)
+{
+    AdcBlock block;
+
+    if (! readBlock(block)) return false;
+    aval = (block.sum + block.count / 2) / block.count;
+    return true;
+}
+
+AdcSource AdcFreeRunAvr::source()
+{
+    return { _read, this, true };
+}
+
+uint32_t AdcFreeRunAvr::getBlocks()
+{
+    uint32_t seq;
+    do { seq = _seq; } while (seq != _seq);
+    return seq;
+}
+
+uint32_t AdcFreeRunAvr::getLostBlocks()
+{
+    return _lost;
+}
+
+bool AdcFreeRunAvr::_read(void *ctx, uint16_t &aval)
+{
+    return static_cast<AdcFreeRunAvr *>(ctx)->read(aval);
+}
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * Header       AdcFreeRunAvr.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration of the class AdcFreeRunAvr. The ADC of the ATmega328 runs in 
+ *              free-running mode, the ADC_vect interrupt adds each conversion to the 
+ *              current block. A completed block is stored in one half of a double buffer 
+ *              and a sequence counter is incremented. The main loop reads the latest block
+ *              without ever waiting ~100 µs for analogRead().
+ * 
+ * Usage        AdcFreeRunAvr adcFree;
+ *              adcFree.begin(adcUno.pin, 16);         // blocks of 16 conversions
+ *              ntcSensor.setSource(adcFree.source());
+ * 
+ * Remarks      At a prescaler of 128 the ADC converts 9615 times per second, a block
+ *              of 16 conversions is complete every 1.7 ms. While the free-running mode 
+ *              is active analogRead() must not be used. The reference is AVcc as with 
+ *              analogRead().
+ * 
+ *              The interrupt and the main loop share no lock. The interrupt writes the 
+ *              block into the buffer which is not the latest one and then increments 
+ *              the sequence counter (4 byte on AVR, so the reader checks it twice). The 
+ *              reader copies the latest block and repeats if the counter has changed 
+ *              meanwhile. A reading is never torn and the interrupt never waits.
+ */
+#ifndef _ADCFREERUNAVR_H_
+#define _ADCFREERUNAVR_H_
+#include <Arduino.h>
+#include "NTCsensor.h"
+
+#ifdef __AVR__
+
+using AdcBlock = struct adcBlock { uint32_t sum; uint16_t count; uint16_t min; uint16_t max; };
+
+class AdcFreeRunAvr
+{
+    public:
+        void     begin(uint8_t pin, uint16_t blockSize = 16);
+        void     end();
+        bool     readBlock(AdcBlock &block);    // latest block, false if not newer than the last one read
+        bool     read(uint16_t &aval);          // rounded mean of the latest block, false if none is new
+        AdcSource source();                     // source for NTCsensor::setSource()
+        uint32_t getBlocks();                   // number of completed blocks
+        uint32_t getLostBlocks();               // blocks overwritten before they were read
+
+        static void isr();                      // called by ADC_vect
+
+    private:
+        static AdcFreeRunAvr *_instance;        // the ADC exists only once
+
+        uint16_t          _blockSize = 16;
+        AdcBlock          _acc;                 // block in progress, used by the interrupt only
+        AdcBlock          _buf[2];              // completed blocks
+        volatile uint32_t _seq    = 0;          // completed blocks, _buf[_seq & 1] is the latest
+        uint32_t          _seqRead = 0;         // sequence of the last block read
+        uint32_t          _lost    = 0;
+
+        void _accumulate(uint16_t aval);
+        static bool _read(void *ctx, uint16_t &aval);
+};
+
+#endif
+#endif
@@ -0,0 +1,175 @@
+/**
+ * Class        NTCanticipator.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the classes SlopeEstimator and NTCanticipator
+ *
+ * Equations    Least squares slope of n samples (x, y)
+ *                  slope = (n * Sxy - Sx * Sy) / (n * Sxx - Sx^2)
+ *              x = 0 is the oldest sample. When it leaves the window its terms of Sx, Sxx
+ *              and Sxy are 0, only Sy changes. Moving x = 0 by d to the next sample gives
+ *                  Sxx -= 2 * d * Sx - n * d^2     Sxy -= d * Sy     Sx -= n * d
+ *              so a sample costs the same few multiplications, whatever the window.
+ *
+ * Board        Arduino uno, Wemos D1 R2, ESP32 DevKit V1
+ *
+ **/
+
+#include "NTCanticipator.h"
+
+#define SLOPE_MIN_LEARN 5       // centi-°C per minute, flatter heating cycles teach nothing
+
+/*
+ * ------------------------------ SlopeEstimator ------------------------------
+ */
+void SlopeEstimator::add(uint32_t ms, int16_t cCelsius)
+{
+    if (_n == _window)                                      // drop the oldest sample
+    {
+        _sy    -= _c[_oldest];
+        _oldest = (_oldest + 1) % _window;
+        _n--;
+        int64_t d = (uint32_t)(_ms[_oldest] - _msBase);
+        _sxx   += (int64_t)_n * d * d - 2 * d * _sx;
+        _sxy   -= d * _sy;
+        _sx    -= (int64_t)_n * d;
+        _msBase = _ms[_oldest];
+    }
+    if (_n == 0) _msBase = ms;
+
+    uint8_t slot = (_oldest + _n) % _window;
+    int64_t x    = (uint32_t)(ms - _msBase);
+    _ms[slot] = ms;
+    _c[slot]  = cCelsius;
+    _sx  += x;
+    _sxx += x * x;
+    _sy  += cCelsius;
+    _sxy += x * cCelsius;
+    _n++;
+    _fit();
+}
+
+void SlopeEstimator::_fit()
+{
+    _slope = 0;
+    if (_n < 2) return;
+
+    int64_t den = (int64_t)_n * _sxx - _sx * _sx;
+    int64_t num = (int64_t)_n * _sxy - _sx * _sy;
+    if (den <= 0) return;                                   // all samples at the same time
+    const int64_t numMax = INT64_MAX / 60000;
+    int64_t slope = (num > numMax || num < -numMax) ? num / (den / 60000 + 1) : num * 60000 / den;
+    _slope = slope > INT16_MAX ? INT16_MAX : slope < -INT16_MAX ? -INT16_MAX : (int16_t)slope;
+}
+
+int16_t SlopeEstimator::getSlope()
+{
+    return _slope;
+}
+
+uint8_t SlopeEstimator::getCount()
+{
+    return _n;
+}
+
+void SlopeEstimator::setWindow(uint8_t window)
+{
+    _window = window < 2 ? 2 : window > NTC_SLOPE_WINDOW ? NTC_SLOPE_WINDOW : window;
+    reset();
+}
+
+void SlopeEstimator::reset()
+{
+    _oldest = 0;
+    _n      = 0;
+    _msBase = 0;
+    _sx = _sxx = _sxy = 0;
+    _sy     = 0;
+    _slope  = 0;
+}
+
+/*
+ * ------------------------------ NTCanticipator ------------------------------
+ */
+
+/**
+ * Learning ends when the temperature falls below the peak or msLagMax 
+ * after switch off. A flat slope alone is not enough, the steps of the 
+ * ADC let it be 0 while the room is still warming.
+ */
+void NTCanticipator::add(const Reading &r)
+{
+    _slope.add(r.ms, r.cCelsius);
+    _msLast = r.ms;
+    _cLast  = r.cCelsius;
+    if (! _isTracking) return;
+    if (r.cCelsius > _cPeak) _cPeak = r.cCelsius;
+    if ((_slope.getSlope() <= 0 && r.cCelsius < _cPeak) || r.ms - _msOff >= _msLagMax)
+    {
+        _isTracking = false;
+        _learn();
+    }
+}
+
+int16_t NTCanticipator::project(int16_t cCelsius)
+{
+    int32_t c = cCelsius + (int32_t)_slope.getSlope() * (int32_t)(_msLag / 1000) / 60;
+    return c > INT16_MAX ? INT16_MAX : c < INT16_MIN ? INT16_MIN : (int16_t)c;
+}
+
+void NTCanticipator::switchedOff(int16_t cLimit)
+{
+    _cLimit     = cLimit;
+    _cPeak      = _cLast;
+    _slopeOff   = _slope.getSlope();
+    _msOff      = _msLast;
+    _isTracking = true;
+}
+
+/**
+ * The lag is off by overshoot / slope, half of it is corrected
+ */
+void NTCanticipator::_learn()
+{
+    _cOvershoot = _cPeak - _cLimit;
+    if (_slopeOff < SLOPE_MIN_LEARN) return;
+
+    int32_t msError = (int32_t)_cOvershoot * 60000L / _slopeOff;
+    int32_t msLag   = (int32_t)_msLag + msError / 2;
+    _msLag = msLag < 0 ? 0 : (uint32_t)msLag > _msLagMax ? _msLagMax : (uint32_t)msLag;
+    _cycles++;
+}
+
+int16_t NTCanticipator::getSlope()
+{
+    return _slope.getSlope();
+}
+
+uint32_t NTCanticipator::getLag()
+{
+    return _msLag;
+}
+
+void NTCanticipator::setLag(uint32_t msLag)
+{
+    _msLag = msLag > _msLagMax ? _msLagMax : msLag;
+}
+
+int16_t NTCanticipator::getOvershoot()
+{
+    return _cOvershoot;
+}
+
+uint16_t NTCanticipator::getCycles()
+{
+    return _cycles;
+}
+
+/**
+ * Forget the samples, the learned lag is kept
+ */
+void NTCanticipator::reset()
+{
+    _slope.reset();
+    _isTracking = false;
+}
@@ -0,0 +1,100 @@
+/**
+ * Header       NTCanticipator.h
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Declaration of the classes SlopeEstimator and NTCanticipator. With thermal
+ *              lag the room keeps warming after the heating is switched off, the on/off
+ *              thermostat overshoots the upper limit. The anticipator projects the
+ *              temperature lag ms ahead from its slope and lets the thermostat switch off
+ *              as soon as the projection exceeds the upper limit. The lag is learned from
+ *              the overshoot of each heating cycle.
+ *
+ *              SlopeEstimator  least squares line through the last n samples, updated
+ *                              in O(1) by running sums, the oldest sample is subtracted.
+ *                              The samples need not be equally spaced.
+ *              NTCanticipator  projection and learning of the lag
+ *
+ * Learning     At switch off the slope s is kept and the peak is tracked until the slope
+ *              turns negative. Overshoot = peak - limit. If the lag were right the peak
+ *              would just reach the limit, so lag += (overshoot / s) / 2, an undershoot
+ *              shortens the lag. With the room's lag L and a steady slope the overshoot
+ *              is s * (L - lag), the lag converges to L.
+ *
+ * Usage        NTCanticipator anticipator(16);             // slope over 16 samples, lag learned
+ *              thermostat.useAnticipator(anticipator);
+ *
+ * Remarks      The peak is the largest sample, so noise is taken for overshoot. Use
+ *              a filter of NTCfilter with the anticipator. Only used in on/off mode,
+ *              the PID controller has its own derivative term.
+ */
+#ifndef _NTCANTICIPATOR_H_
+#define _NTCANTICIPATOR_H_
+#include <Arduino.h>
+#include "NTCsensor.h"
+
+#ifndef NTC_SLOPE_WINDOW
+  #define NTC_SLOPE_WINDOW 32   // max. samples of a SlopeEstimator, 6 bytes each
+#endif
+
+/**
+ * The sums are exact integers, x in ms relative to the oldest sample, so the
+ * estimate doesn't drift. The window should span less than 2 h.
+ */
+class SlopeEstimator
+{
+    public:
+        SlopeEstimator(uint8_t window = 16) { setWindow(window); }
+
+        void     add(uint32_t ms, int16_t cCelsius);  // one sample, the oldest is dropped if the window is full
+        int16_t  getSlope();            // centi-°C per minute, 0 with less than 2 samples
+        uint8_t  getCount();            // samples in the window
+        void     setWindow(uint8_t window);  // 2 .. NTC_SLOPE_WINDOW samples, resets
+        void     reset();
+
+    private:
+        uint32_t _ms[NTC_SLOPE_WINDOW];
+        int16_t  _c[NTC_SLOPE_WINDOW];
+        uint8_t  _window;
+        uint8_t  _oldest;
+        uint8_t  _n;
+        uint32_t _msBase;               // time of the oldest sample, x = 0
+        int64_t  _sx, _sxx, _sxy;       // sums of x, x^2, x*y
+        int32_t  _sy;                   // sum of y
+        int16_t  _slope;
+
+        void     _fit();
+};
+
+class NTCanticipator
+{
+    public:
+        NTCanticipator(uint8_t window = 16, uint32_t msLag = 0, uint32_t msLagMax = 1800000UL) :
+                       _slope(window), _msLag(msLag), _msLagMax(msLagMax) {}
+
+        void     add(const Reading &r);          // called by the thermostat with each sample
+        int16_t  project(int16_t cCelsius);      // temperature in centi-°C lag ms ahead
+        void     switchedOff(int16_t cLimit);    // called by the thermostat, starts learning
+        int16_t  getSlope();                     // centi-°C per minute
+        uint32_t getLag();                       // ms
+        void     setLag(uint32_t msLag);
+        int16_t  getOvershoot();                 // centi-°C of the last heating cycle, < 0 undershoot
+        uint16_t getCycles();                    // heating cycles learned from
+        void     reset();
+
+    private:
+        SlopeEstimator _slope;
+        uint32_t _msLag;
+        uint32_t _msLagMax;
+        bool     _isTracking = false;            // peak after switch off not reached yet
+        int16_t  _cLimit     = 0;
+        int16_t  _cPeak      = 0;
+        int16_t  _slopeOff   = 0;                // slope at switch off
+        uint32_t _msOff      = 0;
+        int16_t  _cOvershoot = 0;
+        uint16_t _cycles     = 0;
+        uint32_t _msLast     = 0;                // last sample
+        int16_t  _cLast      = 0;
+
+        void     _learn();
+};
+#endif
@@ -0,0 +1,178 @@
+/**
+ * Class        NTCcalibration.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class NTCcalibration 
+ * 
+ * Equations    Beta model from 2 points (T1, R1), (T2, R2), T in K
+ * 
+ *              BETA = ln(R1 / R2) / (1/T1 - 1/T2)
+ *              Ro   = R1 * exp(BETA * (1/To - 1/T1))
+ * 
+ *              Steinhart-Hart model from 3 points, see NTCsensor::fitSteinhartHart()
+ * 
+ *              ESP32 ADC: esp_adc_cal converts a raw value to mV with the reference 
+ *              voltage or the two point values burnt into the eFuses. Its curve is 
+ *              sampled at NTC_ADC_KNOTS + 1 analog values for each attenuation, the 
+ *              sensor interpolates linearly between them. So the bend of the 11 dB 
+ *              attenuation at the upper end is kept. Voff and Vref become the first 
+ *              and the last knot.
+ * 
+ * Board        Arduino uno, Wemos D1 R2, ESP32 DevKit V1
+ * 
+ **/
+
+#include "NTCcalibration.h"
+#ifdef ESP32
+  #include <esp_adc_cal.h>
+#endif
+
+void NTCcalibration::reset()
+{
+    _points = 0;
+}
+
+/**
+ * Average samples samples of the sensor at the reference temperature 
+ * celsius. Each sample may itself be oversampled (ParamsADC.ovs), the 
+ * mean is kept as analog value without the extra bits. Blocks until 
+ * all samples are taken.
+ */
+bool NTCcalibration::addPoint(double celsius, uint16_t samples)
+{
+    double sum = 0.0;
+
+    if (_points >= 3 || samples == 0) return false;
+    for (uint16_t i = 0; i < samples; i++) sum += _ntcSensor.sample().raw;
+    _celsius[_points] = celsius;
+    _aval[_points]    = sum / samples / (double)(1u << _ntcSensor.getExtraBits());
+    _points++;
+    return true;
+}
+
+uint8_t NTCcalibration::getPoints()
+{
+    return _points;
+}
+
+double NTCcalibration::getAnalogValue(uint8_t i)
+{
+    return i < _points ? _aval[i] : NAN;
+}
+
+double NTCcalibration::getRt(uint8_t i)
+{
+    return i < _points ? _ntcSensor.getRtAt(_aval[i]) : NAN;
+}
+
+/**
+ * Determine the Beta model from 2 points or the Steinhart-Hart 
+ * model from 3 points and reconfigure the sensor, which rebuilds 
+ * or drops a lookup table of the old parameters
+ */
+bool NTCcalibration::solve()
+{
+    bool ok = false;
+
+    if (_points == 2) ok = _solveBeta();
+    if (_points == 3) ok = _solveSteinhartHart();
+    if (ok) _ntcSensor.reconfigure();
+    return ok;
+}
+
+bool NTCcalibration::_solveBeta()
+{
+    double r1   = getRt(0);
+    double r2   = getRt(1);
+    double t1   = _celsius[0] + 273.15;
+    double t2   = _celsius[1] + 273.15;
+    double beta = log(r1 / r2) / (1.0 / t1 - 1.0 / t2);
+    double ro   = r1 * exp(beta * (1.0 / 298.15 - 1.0 / t1));
+
+    if (! (beta >= 1.0 && beta <= 65535.0) || ! (ro >= 1.0 && ro <= 65535.0)) return false;   // also NaN
+
+    ParamsNTC &ntc = _ntcSensor.getParamsNTC();
+    ntc.beta = (uint16_t)lround(beta);
+    ntc.Ro   = (uint16_t)lround(ro);
+    ntc.sh   = nullptr;
+    return true;
+}
+
+bool NTCcalibration::_solveSteinhartHart()
+{
+    double   rt[3] = { getRt(0), getRt(1), getRt(2) };
+    ParamsSH sh;
+
+    if (! NTCsensor::fitSteinhartHart(sh, _celsius, rt)) return false;
+    _sh = sh;
+    _ntcSensor.getParamsNTC().sh = &_sh;
+    return true;
+}
+
+bool NTCcalibration::save(NTCconfig &config, NTCthermostat &thermostat)
+{
+    return config.store(_ntcSensor, thermostat);
+}
+
+#ifdef ESP32
+/**
+ * Replace Vref and Voff of ParamsADC and of each range of the 
+ * auto-ranging by the characteristic esp_adc_cal reports for their 
+ * attenuations and set the curves of the sensor. Returns false and 
+ * leaves the sensor unchanged if the chip has no calibration in its 
+ * eFuses or the pin is not on ADC1.
+ * 
+ * mvVrefDefault  reference voltage if the eFuses hold none
+ */
+bool NTCcalibration::characterizeAdc(uint32_t mvVrefDefault)
+{
+    ParamsADC        &adc     = _ntcSensor.getParamsADC();
+    ParamsADC *const *ranges  = _ntcSensor.getRanges();
+    int8_t            channel = digitalPinToAnalogChannel(adc.pin);
+
+    if (channel < 0 || channel >= 10) return false;               // ADC2 is not characterized here
+    esp_adc_cal_characteristics_t chars;
+    if (esp_adc_cal_characterize(ADC_UNIT_1, (adc_atten_t)adc.att, ADC_WIDTH_BIT_12, mvVrefDefault, &chars) == ESP_ADC_CAL_VAL_DEFAULT_VREF) return false;
+
+    _adcFitError = 0.0;
+    _characterize(adc, mvVrefDefault);
+    for (uint8_t r = 0; r < _ntcSensor.getRangeCount(); r++) _characterize(*ranges[r], mvVrefDefault);
+    _ntcSensor.reconfigure();
+    return true;
+}
+
+/**
+ * Sample the curve of the attenuation of adc at the knots and check 
+ * the interpolation at every raw value
+ */
+bool NTCcalibration::_characterize(ParamsADC &adc, uint32_t mvVrefDefault)
+{
+    if (adc.att >= NTC_ADC_ATTENUATIONS) return false;
+
+    esp_adc_cal_characteristics_t chars;
+    AdcCurve &curve = _curves[adc.att];
+
+    esp_adc_cal_characterize(ADC_UNIT_1, (adc_atten_t)adc.att, ADC_WIDTH_BIT_12, mvVrefDefault, &chars);
+    for (uint8_t i = 0; i <= NTC_ADC_KNOTS; i++)
+    {
+        curve.mv[i] = esp_adc_cal_raw_to_voltage((uint32_t)lround(i * 4095.0 / NTC_ADC_KNOTS), &chars);
+    }
+    for (uint32_t raw = 0; raw <= 4095; raw++)
+    {
+        double  pos = raw * (double)NTC_ADC_KNOTS / 4095.0;
+        uint8_t i   = pos < NTC_ADC_KNOTS ? (uint8_t)pos : NTC_ADC_KNOTS - 1;
+        double  mv  = curve.mv[i] + (curve.mv[i + 1] - curve.mv[i]) * (pos - i);
+        double  e   = fabs(esp_adc_cal_raw_to_voltage(raw, &chars) - mv);
+        if (e > _adcFitError) _adcFitError = e;
+    }
+    adc.Voff = curve.mv[0];
+    adc.Vref = curve.mv[NTC_ADC_KNOTS];
+    _ntcSensor.setAdcCurve(adc.att, &curve);
+    return true;
+}
+
+double NTCcalibration::getAdcFitError()
+{
+    return _adcFitError;
+}
+#endif
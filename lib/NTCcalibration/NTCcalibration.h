@@ -0,0 +1,78 @@
+/**
+ * Header       NTCcalibration.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration of the class NTCcalibration which determines the parameters
+ *              of a NTCsensor from reference temperatures:
+ * 
+ *              2 points    Ro and BETA of the Beta model
+ *              3 points    A, B and C of the Steinhart-Hart model
+ * 
+ *              On the ESP32 characterizeAdc() replaces the hand tuned Vref and Voff by 
+ *              the ADC characteristic which esp_adc_cal derives from the eFuse 
+ *              calibration of the chip, a curve for each attenuation in use.
+ * 
+ * Constructor
+ * arguments    &ntcSensor  the sensor to calibrate
+ * 
+ * Usage        NTCcalibration cal(ntcSensor);
+ *              cal.characterizeAdc();      // ESP32 only
+ *              cal.addPoint(0.0);          // sensor in ice water, blocks while sampling
+ *              cal.addPoint(25.0);         // sensor at the reference temperatures
+ *              cal.addPoint(50.0);
+ *              if (cal.solve()) cal.save(config, thermostat);
+ * 
+ * Remarks      addPoint() averages many samples and keeps the analog value, so the 
+ *              points may be taken before or after characterizeAdc(). 
+ *              The object holds the Steinhart-Hart coefficients, it must live as long 
+ *              as the sensor uses them, the same for the curves of characterizeAdc(). 
+ *              Call useAutoRange() before characterizeAdc(), so all ranges are 
+ *              characterized. solve() reconfigures the sensor: a table of 
+ *              buildLookupTable() is built again with the new parameters, a PROGMEM 
+ *              table, which was generated for the old ones, is dropped.
+ */
+#ifndef _NTCCALIBRATION_H_
+#define _NTCCALIBRATION_H_
+#include <Arduino.h>
+#include "NTCsensor.h"
+#include "NTCconfig.h"
+
+#ifndef NTC_CAL_SAMPLES
+  #define NTC_CAL_SAMPLES 256   // samples averaged per reference point
+#endif
+
+class NTCcalibration
+{
+    public:
+        NTCcalibration(NTCsensor &ntcSensor) : _ntcSensor(ntcSensor) {}
+
+        void    reset();                       // discard all points
+        bool    addPoint(double celsius, uint16_t samples = NTC_CAL_SAMPLES);  // false if 3 points are taken
+        uint8_t getPoints();
+        double  getAnalogValue(uint8_t i);     // mean analog value of point i
+        double  getRt(uint8_t i);              // resistance of point i with the actual ADC parameters
+        bool    solve();                       // set the parameters of the sensor, false if not determined
+        bool    save(NTCconfig &config, NTCthermostat &thermostat);  // store the parameters, true if written
+      #ifdef ESP32
+        bool    characterizeAdc(uint32_t mvVrefDefault = 1100);  // ParamsADC and all ranges of the sensor
+        double  getAdcFitError();              // max. deviation in mV of the curves from esp_adc_cal
+      #endif
+
+    private:
+        NTCsensor &_ntcSensor;
+        double    _celsius[3];
+        double    _aval[3];
+        uint8_t   _points = 0;
+        ParamsSH  _sh     = {};
+      #ifdef ESP32
+        AdcCurve  _curves[NTC_ADC_ATTENUATIONS];
+        double    _adcFitError = NAN;
+      #endif
+
+        bool _solveBeta();
+        bool _solveSteinhartHart();
+      #ifdef ESP32
+        bool _characterize(ParamsADC &adc, uint32_t mvVrefDefault);
+      #endif
+};
+#endif
@@ -0,0 +1,257 @@
+/**
+ * Class        NTCconfig.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class NTCconfig, a versioned and CRC checked configuration 
+ *              blob in EEPROM, EEPROM emulation or NVS.
+ * 
+ * Board        Arduino uno, Wemos D1 R2, ESP32 DevKit V1
+ * 
+ **/
+
+#include "NTCconfig.h"
+
+#ifdef ESP32
+  #include <Preferences.h>
+  static const char *nvsNamespace = "ntc";
+  static const char *nvsKey       = "cfg";
+#else
+  #include <EEPROM.h>
+#endif
+
+/**
+ * Restore the parameters of the sensor and the thermostat and a 
+ * stored lookup table
+ */
+bool NTCconfig::restore(NTCsensor &ntcSensor, NTCthermostat &thermostat)
+{
+    if (! load(_cfg)) return false;
+
+    ParamsADC &adc = ntcSensor.getParamsADC();
+    ParamsNTC &ntc = ntcSensor.getParamsNTC();
+    ntc.Rs   = _cfg.Rs;
+    ntc.Ro   = _cfg.Ro;
+    ntc.beta = _cfg.beta;
+    _sh      = { _cfg.shA, _cfg.shB, _cfg.shC };
+    ntc.sh   = _cfg.hasSH ? &_sh : nullptr;
+    adc.Vcc  = _cfg.Vcc;
+    adc.Vref = _cfg.Vref;
+    adc.Voff = _cfg.Voff;
+    #ifdef ESP32
+      adc.att = (adc_attenuation_t)_cfg.att;
+    #endif
+    ntcSensor.reconfigure();
+  #if NTC_CONFIG_LUT_MAX > 0
+    if (_cfg.lutSize > 0) ntcSensor.useLookupTable({ _cfg.lut, _cfg.lutSize, _cfg.lutShift, false });
+  #endif
+
+    thermostat.setLimitLow(_cfg.cLimitLow / 100.0f);
+    thermostat.setLimitHigh(_cfg.cLimitHigh / 100.0f);
+    thermostat.setRefreshInterval(_cfg.msRefresh);
+    thermostat.setMinOnTime(_cfg.msMinOn);
+    thermostat.setMinOffTime(_cfg.msMinOff);
+    return true;
+}
+
+/**
+ * Store the actual configuration, a lookup table only if it is in RAM
+ */
+bool NTCconfig::store(NTCsensor &ntcSensor, NTCthermostat &thermostat)
+{
+    ConfigNTC  cfg;
+    ParamsADC &adc = ntcSensor.getParamsADC();
+    ParamsNTC &ntc = ntcSensor.getParamsNTC();
+
+    memset(&cfg, 0, sizeof(cfg));   // padding too, it is part of the CRC
+    cfg.Rs         = ntc.Rs;
+    cfg.Ro         = ntc.Ro;
+    cfg.beta       = ntc.beta;
+    if (ntc.sh != nullptr)
+    {
+        cfg.hasSH  = 1;
+        cfg.shA    = ntc.sh->A;
+        cfg.shB    = ntc.sh->B;
+        cfg.shC    = ntc.sh->C;
+    }
+    cfg.Vcc        = adc.Vcc;
+    cfg.Vref       = adc.Vref;
+    cfg.Voff       = adc.Voff;
+    #ifdef ESP32
+      cfg.att      = adc.att;
+    #endif
+    cfg.cLimitLow  = thermostat.getCentiLimitLow();
+    cfg.cLimitHigh = thermostat.getCentiLimitHigh();
+    cfg.msRefresh  = thermostat.getRefreshInterval();
+    cfg.msMinOn    = thermostat.getMinOnTime();
+    cfg.msMinOff   = thermostat.getMinOffTime();
+  #if NTC_CONFIG_LUT_MAX > 0
+    const LutNTC &lut = ntcSensor.getLookupTable();
+    if (lut.table != nullptr && ! lut.inProgmem && lut.size <= NTC_CONFIG_LUT_MAX)
+    {
+        memcpy(cfg.lut, lut.table, lut.size * sizeof(int16_t));
+        cfg.lutSize  = lut.size;
+        cfg.lutShift = lut.shift;
+    }
+  #endif
+    return save(cfg);
+}
+
+/**
+ * Load the newest valid blob
+ */
+bool NTCconfig::load(ConfigNTC &cfg)
+{
+    ConfigNTC tmp;
+    bool      found = false;
+
+    _slot = -1;
+    for (uint8_t slot = 0; slot < _slots(); slot++)
+    {
+        if (! _read(slot, tmp) || ! _isValid(tmp)) continue;
+        if (! found || (int32_t)(tmp.seq - cfg.seq) > 0)
+        {
+            cfg   = tmp;
+            _slot = slot;
+            found = true;
+        }
+    }
+    if (found && &cfg != &_cfg) _cfg = cfg;
+    return found;
+}
+
+/**
+ * Write cfg into the next slot unless it equals the stored blob.
+ * Header, sequence and CRC are set here.
+ */
+bool NTCconfig::save(ConfigNTC &cfg)
+{
+    ConfigNTC stored;
+    bool      hasStored = load(stored);
+
+    cfg.magic   = NTC_CONFIG_MAGIC;
+    cfg.version = NTC_CONFIG_VERSION;
+    if (hasStored)
+    {
+        cfg.seq = stored.seq;
+        cfg.crc = _crc16((const uint8_t *)&cfg, offsetof(ConfigNTC, crc));
+        if (cfg.crc == stored.crc && memcmp(&cfg, &stored, sizeof(cfg)) == 0) return false;   // unchanged
+    }
+    cfg.seq = hasStored ? stored.seq + 1 : 1;
+    cfg.crc = _crc16((const uint8_t *)&cfg, offsetof(ConfigNTC, crc));
+
+    uint8_t slot = (_slot + 1) % _slots();                      // round-robin over the slots
+    if (! _write(slot, cfg)) return false;
+    _cfg  = cfg;
+    _slot = slot;
+    return true;
+}
+
+ConfigNTC &NTCconfig::getConfig()
+{
+    return _cfg;
+}
+
+/**
+ * CRC-16/CCITT-FALSE
+ */
+uint16_t NTCconfig::_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    while (len--)
+    {
+        crc ^= (uint16_t)*data++ << 8;
+        for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+bool NTCconfig::_isValid(const ConfigNTC &cfg)
+{
+    return cfg.magic == NTC_CONFIG_MAGIC && cfg.version == NTC_CONFIG_VERSION
+        && cfg.lutSize <= NTC_CONFIG_LUT_MAX
+        && cfg.crc == _crc16((const uint8_t *)&cfg, offsetof(ConfigNTC, crc));
+}
+
+#if defined(ESP32)
+/**
+ * NVS is wear leveled by itself, one key is enough
+ */
+uint8_t NTCconfig::_slots()
+{
+    return 1;
+}
+
+bool NTCconfig::_read(uint8_t slot, ConfigNTC &cfg)
+{
+    Preferences prefs;
+    (void)slot;
+    if (! prefs.begin(nvsNamespace, true)) return false;
+    size_t len = prefs.getBytes(nvsKey, &cfg, sizeof(cfg));
+    prefs.end();
+    return len == sizeof(cfg);
+}
+
+bool NTCconfig::_write(uint8_t slot, const ConfigNTC &cfg)
+{
+    Preferences prefs;
+    (void)slot;
+    if (! prefs.begin(nvsNamespace, false)) return false;
+    size_t len = prefs.putBytes(nvsKey, &cfg, sizeof(cfg));
+    prefs.end();
+    return len == sizeof(cfg);
+}
+
+#elif defined(ESP8266)
+/**
+ * The emulation erases a whole flash sector on commit(), 
+ * so slots don't help. commit() writes only if a byte has changed.
+ */
+uint8_t NTCconfig::_slots()
+{
+    return 1;
+}
+
+bool NTCconfig::_read(uint8_t slot, ConfigNTC &cfg)
+{
+    (void)slot;
+    EEPROM.begin(NTC_CONFIG_EEPROM_START + sizeof(ConfigNTC));
+    EEPROM.get(NTC_CONFIG_EEPROM_START, cfg);
+    EEPROM.end();
+    return true;
+}
+
+bool NTCconfig::_write(uint8_t slot, const ConfigNTC &cfg)
+{
+    (void)slot;
+    EEPROM.begin(NTC_CONFIG_EEPROM_START + sizeof(ConfigNTC));
+    EEPROM.put(NTC_CONFIG_EEPROM_START, cfg);
+    bool ok = EEPROM.commit();
+    EEPROM.end();
+    return ok;
+}
+
+#else
+/**
+ * EEPROM slots, EEPROM.update() writes only the bytes which differ
+ */
+uint8_t NTCconfig::_slots()
+{
+    uint16_t n = (EEPROM.length() - NTC_CONFIG_EEPROM_START) / sizeof(ConfigNTC);
+    return n < NTC_CONFIG_SLOTS ? n : NTC_CONFIG_SLOTS;
+}
+
+bool NTCconfig::_read(uint8_t slot, ConfigNTC &cfg)
+{
+    EEPROM.get(NTC_CONFIG_EEPROM_START + slot * sizeof(ConfigNTC), cfg);
+    return true;
+}
+
+bool NTCconfig::_write(uint8_t slot, const ConfigNTC &cfg)
+{
+    const uint8_t *p    = (const uint8_t *)&cfg;
+    int            addr = NTC_CONFIG_EEPROM_START + slot * sizeof(ConfigNTC);
+
+    for (size_t i = 0; i < sizeof(cfg); i++) EEPROM.update(addr + i, p[i]);
+    return true;
+}
+#endif
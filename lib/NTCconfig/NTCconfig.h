@@ -0,0 +1,94 @@
+/**
+ * Header       NTCconfig.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration of the class NTCconfig which keeps the configuration of a 
+ *              sensor and its thermostat in non-volatile memory:
+ * 
+ *              Arduino uno     EEPROM, the blob is written round-robin into slots 
+ *                              (wear leveling), the newest valid slot wins
+ *              Wemos D1        EEPROM emulation in flash
+ *              ESP32           NVS (Preferences), which does its own wear leveling
+ * 
+ *              The blob holds a magic number, a version, a sequence number, the NTC
+ *              and ADC parameters including the Steinhart-Hart coefficients, the limits, the refresh interval, the minimum on and
+ *              off times and a lookup table built at runtime. A CRC-16 protects it. 
+ *              store() writes only if the configuration has changed.
+ * 
+ * Usage        NTCconfig config;
+ *              if (! config.restore(ntcSensor, thermostat))  // nothing stored yet
+ *              {
+ *                  ... set the defaults, build the table
+ *                  config.store(ntcSensor, thermostat);
+ *              }
+ * 
+ * Remarks      The object holds the restored lookup table and Steinhart-Hart coefficients, 
+ *              so it must live as long as the sensor uses them.
+ *              A table set before restore(), e.g. the PROGMEM table of the Uno, is only kept 
+ *              if the restored parameters are the ones it was set with, otherwise the sensor 
+ *              converts with the model, see NTCsensor::reconfigure().
+ */
+#ifndef _NTCCONFIG_H_
+#define _NTCCONFIG_H_
+#include <Arduino.h>
+#include "NTCsensor.h"
+#include "NTCthermostat.h"
+
+#ifndef NTC_CONFIG_LUT_MAX
+  #ifdef __AVR__
+    #define NTC_CONFIG_LUT_MAX 0    // the Uno uses a PROGMEM table and has little RAM
+  #else
+    #define NTC_CONFIG_LUT_MAX 65   // max. entries of a stored lookup table
+  #endif
+#endif
+#ifndef NTC_CONFIG_EEPROM_START
+  #define NTC_CONFIG_EEPROM_START 0 // first EEPROM address used
+#endif
+#ifndef NTC_CONFIG_SLOTS
+  #define NTC_CONFIG_SLOTS 4        // slots for wear leveling on AVR
+#endif
+
+#define NTC_CONFIG_MAGIC   0x4E43   // "NC"
+#define NTC_CONFIG_VERSION 2
+
+using ConfigNTC = struct configNtc 
+{ 
+    uint16_t  magic; 
+    uint8_t   version; 
+    uint8_t   att;                  // attenuation on ESP32
+    uint32_t  seq;                  // incremented with each write
+    uint16_t  Rs, Ro, beta;         // ParamsNTC
+    uint8_t   hasSH;                // 1 if the Steinhart-Hart coefficients are valid
+    float     shA, shB, shC;
+    float     Vcc, Vref, Voff;      // mV
+    int16_t   cLimitLow, cLimitHigh;
+    uint32_t  msRefresh, msMinOn, msMinOff;
+    uint16_t  lutSize;              // 0 if no table is stored
+    uint8_t   lutShift;
+  #if NTC_CONFIG_LUT_MAX > 0
+    int16_t   lut[NTC_CONFIG_LUT_MAX];
+  #endif
+    uint16_t  crc;                  // CRC-16 of all bytes before
+};
+
+class NTCconfig
+{
+    public:
+        bool restore(NTCsensor &ntcSensor, NTCthermostat &thermostat);  // false if nothing valid is stored
+        bool store(NTCsensor &ntcSensor, NTCthermostat &thermostat);    // true if written
+        bool load(ConfigNTC &cfg);          // newest valid blob
+        bool save(ConfigNTC &cfg);          // write if different from the stored blob
+        ConfigNTC &getConfig();             // the blob last loaded or saved
+
+    private:
+        ConfigNTC _cfg  = {};
+        ParamsSH  _sh   = {};               // restored Steinhart-Hart coefficients
+        int8_t    _slot = -1;               // slot of _cfg, -1 if none
+
+        static uint16_t _crc16(const uint8_t *data, size_t len);
+        static bool     _isValid(const ConfigNTC &cfg);
+        bool _read(uint8_t slot, ConfigNTC &cfg);
+        bool _write(uint8_t slot, const ConfigNTC &cfg);
+        uint8_t _slots();
+};
+#endif
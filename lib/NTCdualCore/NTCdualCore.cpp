@@ -0,0 +1,144 @@
+/**
+ * Class        NTCdualCore.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class NTCdualCore, see NTCdualCore.h
+ *
+ * Board        ESP32 DevKit V1
+ */
+
+#include "NTCdualCore.h"
+
+#ifdef ESP32
+
+bool NTCdualCore::begin(uint8_t core, UBaseType_t priority)
+{
+    if (_task != nullptr) return true;
+    if (_timer == nullptr)
+    {
+        esp_timer_create_args_t args = {};
+        args.callback        = _wake;
+        args.arg             = this;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name            = "NTCcontrol";
+        if (esp_timer_create(&args, &_timer) != ESP_OK) return false;
+    }
+    return xTaskCreatePinnedToCore(_run, "NTCcontrol", NTC_CORE_STACK, this, priority, &_task, core) == pdPASS;
+}
+
+/**
+ * Called on the control core with each new sample, measures
+ * how much the period deviates from the refresh interval
+ */
+bool NTCdualCore::push(const Reading &r)
+{
+    uint32_t usNow = micros();
+    if (_usLast != 0)
+    {
+        int32_t  dev = (int32_t)(usNow - _usLast - _msInterval * 1000UL);
+        uint32_t abs = dev < 0 ? -dev : dev;
+        if (abs > _usJitterMax) _usJitterMax = abs;
+    }
+    _usLast     = usNow;
+    _msInterval = _thermostat.getEffectiveInterval();  // period until the next push()
+    if (_queue.push(r)) return true;
+    _dropped++;
+    return false;
+}
+
+void NTCdualCore::loop()
+{
+    Reading r;
+    while (_queue.pop(r))
+    {
+        if (_onReport != nullptr) _onReport(_ctx, r);
+    }
+}
+
+void NTCdualCore::setControlHook(ControlHook hook, void *ctx)
+{
+    _hookCtx = ctx;
+    _hook    = hook;
+}
+
+uint32_t NTCdualCore::getDropped()
+{
+    return _dropped;
+}
+
+uint32_t NTCdualCore::getMaxJitter()
+{
+    return _usJitterMax;
+}
+
+/**
+ * The first period after a reset is not measured
+ */
+void NTCdualCore::resetJitter()
+{
+    _usLast      = 0;
+    _usJitterMax = 0;
+}
+
+void NTCdualCore::_run(void *ctx)
+{
+    static_cast<NTCdualCore *>(ctx)->_control();
+}
+
+void NTCdualCore::_wake(void *ctx)
+{
+    xTaskNotifyGive(static_cast<NTCdualCore *>(ctx)->_task);
+}
+
+/**
+ * millis() counts the ms of esp_timer_get_time(), the timer fires at 
+ * the beginning of the due millisecond. The timeout of the wait only 
+ * matters if the timer could not be started.
+ */
+void NTCdualCore::_sleep(uint32_t ms)
+{
+    int64_t usNow = esp_timer_get_time();
+    int64_t usDue = (usNow / 1000 + ms) * 1000;
+
+    ulTaskNotifyTake(pdTRUE, 0);                                // drop a stale wake-up
+    if (esp_timer_start_once(_timer, usDue - usNow) != ESP_OK)
+    {
+        vTaskDelay(pdMS_TO_TICKS(ms));
+        return;
+    }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms) + 2);
+    esp_timer_stop(_timer);                                     // after a timeout
+}
+
+/**
+ * Sleep until the thermostat is due, poll while a sample waits for 
+ * conversions
+ */
+void NTCdualCore::_control()
+{
+    uint16_t spins = 0;
+
+    for (;;)
+    {
+        _thermostat.loop();
+        if (_hook != nullptr) _hook(_hookCtx);
+
+        uint32_t ms = _thermostat.msUntilDue(millis());
+        if (ms == UINT32_MAX)                                   // disabled
+        {
+            vTaskDelay(pdMS_TO_TICKS(NTC_CORE_IDLE_MS));
+            continue;
+        }
+        if (ms > 0)
+        {
+            spins = 0;
+            _sleep(ms);
+            continue;
+        }
+        if (++spins < NTC_CORE_SPINS) continue;                 // a sample waits for conversions
+        spins = 0;
+        vTaskDelay(1);
+    }
+}
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * Header       NTCdualCore.h
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Declaration of the class NTCdualCore, an optional runtime for the ESP32 which
+ *              splits the thermostat from the reporting. A FreeRTOS task pinned to one core
+ *              with a high priority runs NTCthermostat::loop(), i.e. the ADC and the control.
+ *              Printing, telemetry and network run in the Arduino loop() or in tasks of their
+ *              own. Both sides are connected by a lock-free SpscQueue of Reading structs,
+ *              the control task never waits for the reporting side.
+ *
+ * Usage        NTCdualCore dualCore(thermostat, report);     // report(ctx, reading) on the reporting side
+ *              processData()  dualCore.push(reading);         // onDataReady of the thermostat, control core
+ *              setup()        thermostat.enable(); dualCore.begin();
+ *              loop()         dualCore.loop();                // calls report for each queued reading
+ *
+ *              After begin() only the control task may call the thermostat. Use
+ *              setControlHook() for work which has to touch it, e.g. net.loop() of
+ *              NTCnet to apply remote limits.
+ *
+ * Timing       The task blocks until a one-shot esp_timer wakes it at the millisecond the
+ *              thermostat is due, so the tick starts within microseconds of its due time
+ *              instead of somewhere in the next tick of FreeRTOS, and the core is free until
+ *              then. While a sample waits for conversions, e.g. of AdcDmaEsp32, the task
+ *              sleeps one tick after NTC_CORE_SPINS passes. getMaxJitter() reports the
+ *              largest deviation of the period of push() from the effective interval.
+ *
+ * Remarks      The Arduino loop() runs on core 1 with priority 1. The control task is pinned
+ *              to core 1 (NTC_CORE_CONTROL) above it, the WiFi task runs on core 0. As the
+ *              task never waits busy for its tick, loop() gets all the time between two
+ *              ticks. NTCnet posts on the other core, see NTC_NET_CORE. Set both by build
+ *              flags, so every unit sees the same cores. How much jitter is left depends on
+ *              the load, bench/dualcore measures it with and without the split while loop()
+ *              prints.
+ */
+#ifndef _NTCDUALCORE_H_
+#define _NTCDUALCORE_H_
+#include <Arduino.h>
+
+#ifdef ESP32
+#include <esp_timer.h>
+#include "NTCthermostat.h"
+#include "SpscQueue.h"
+
+#ifndef NTC_CORE_QUEUE
+  #define NTC_CORE_QUEUE     32             // readings in the queue, a power of 2
+#endif
+#ifndef NTC_CORE_STACK
+  #define NTC_CORE_STACK     4096           // bytes of stack of the control task
+#endif
+#ifndef NTC_CORE_CONTROL
+  #define NTC_CORE_CONTROL   1              // core of the control task, WiFi runs on core 0
+#endif
+#ifndef NTC_CORE_PRIORITY
+  #define NTC_CORE_PRIORITY  (configMAX_PRIORITIES - 2)
+#endif
+#ifndef NTC_CORE_SPINS
+  #define NTC_CORE_SPINS     64             // passes before a waiting sample gives the core away
+#endif
+#ifndef NTC_CORE_IDLE_MS
+  #define NTC_CORE_IDLE_MS   100            // sleep while the thermostat is disabled
+#endif
+
+using ControlHook = void (*)(void *ctx);
+
+class NTCdualCore
+{
+    public:
+        NTCdualCore(NTCthermostat &thermostat, Callback onReport, void *ctx = nullptr) :
+                    _thermostat(thermostat), _onReport(onReport), _ctx(ctx) {}
+
+        bool     begin(uint8_t core = NTC_CORE_CONTROL, UBaseType_t priority = NTC_CORE_PRIORITY);  // starts the control task
+        bool     push(const Reading &r);    // control core: queue a reading, false if the queue is full
+        void     loop();                    // reporting side: onReport for each queued reading
+        void     setControlHook(ControlHook hook, void *ctx = nullptr);  // called on the control core after each pass
+        uint32_t getDropped();              // readings dropped because the queue was full
+        uint32_t getMaxJitter();            // µs, largest deviation of the period of push()
+        void     resetJitter();
+
+    private:
+        NTCthermostat &_thermostat;
+        Callback     _onReport;
+        void        *_ctx;
+        ControlHook  _hook    = nullptr;
+        void        *_hookCtx = nullptr;
+        SpscQueue<Reading, NTC_CORE_QUEUE> _queue;
+        TaskHandle_t _task    = nullptr;
+        esp_timer_handle_t _timer = nullptr;  // wakes the task when the thermostat is due
+        uint32_t     _dropped = 0;
+        uint32_t     _usLast  = 0;          // time of the last push()
+        uint32_t     _msInterval = 0;       // interval of the thermostat after the last push()
+        volatile uint32_t _usJitterMax = 0;
+
+        static void _run(void *ctx);
+        static void _wake(void *ctx);       // callback of _timer
+        void  _control();
+        void  _sleep(uint32_t ms);          // until the millisecond ms from now begins
+};
+
+#endif
+#endif
@@ -0,0 +1,236 @@
+/**
+ * Class        NTCfilter.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the filters EmaFilter, BiquadFilter, KalmanFilter and FilterChain
+ * 
+ * Equations    The state is kept with 8 fractional bits, so small steps are not lost.
+ * 
+ *              EMA       y = y + (x - y) / 2^shift               delay = 2^shift - 1
+ * 
+ *              Biquad    y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2
+ *                        coefficients from the Audio EQ Cookbook (R. Bristow-Johnson), in Q24.
+ *                        b1 absorbs the rounding so the gain at DC is exactly 1 and the 
+ *                        filter doesn't add an offset to the temperature.
+ *                        delay = 1 - (a1 + 2*a2) / (1 + a1 + a2)     at DC
+ * 
+ *              Kalman    x(n) = x(n-1) + w, w ~ N(0, q)   temperature drifts
+ *                        z(n) = x(n) + v,   v ~ N(0, r)   ADC noise
+ *                        The gain converges to K = M / (M + r) with the prior variance
+ *                        M = (q + sqrt(q^2 + 4*q*r)) / 2. The filter uses this gain from 
+ *                        the start, then it is an EMA with the optimal alpha for q and r.
+ *                        delay = (1 - K) / K
+ * 
+ * Board        Arduino uno, Wemos D1 R2, ESP32 DevKit V1
+ * 
+ **/
+
+#include "NTCfilter.h"
+
+// Output in centi-°C from a state with 8 fractional bits, rounded and clipped
+static int16_t fromQ8(int32_t y)
+{
+    y = (y + 128) >> 8;
+    if (y > INT16_MAX) return INT16_MAX;
+    if (y < INT16_MIN) return INT16_MIN;
+    return (int16_t)y;
+}
+
+/*
+ * ------------------------------ EMA ------------------------------
+ */
+int16_t EmaFilter::apply(int16_t cCelsius)
+{
+    int32_t x = (int32_t)cCelsius << 8;
+
+    if (! _isInitialized)
+    {
+        _y = x;
+        _isInitialized = true;
+    }
+    _y += (x - _y) >> _shift;
+    return fromQ8(_y);
+}
+
+void EmaFilter::reset()
+{
+    _isInitialized = false;
+}
+
+void EmaFilter::setShift(uint8_t shift)
+{
+    _shift = shift > 8 ? 8 : shift;
+}
+
+float EmaFilter::getGroupDelay()
+{
+    return (float)((1u << _shift) - 1);
+}
+
+static int16_t applyEma(void *ctx, int16_t cCelsius)
+{
+    return static_cast<EmaFilter *>(ctx)->apply(cCelsius);
+}
+
+Filter EmaFilter::stage()
+{
+    return { applyEma, this };
+}
+
+/*
+ * ----------------------------- Biquad -----------------------------
+ */
+int16_t BiquadFilter::apply(int16_t cCelsius)
+{
+    if (! _isInitialized)                                    // start in the steady state
+    {
+        _x1 = _x2 = cCelsius;
+        _y1 = _y2 = (int32_t)cCelsius << 8;
+        _isInitialized = true;
+    }
+    int64_t acc = ((int64_t)_b0 * cCelsius + (int64_t)_b1 * _x1 + (int64_t)_b2 * _x2) * 256
+                - (int64_t)_a1 * _y1 - (int64_t)_a2 * _y2;
+    int32_t y   = (int32_t)((acc + (1L << 23)) >> 24);
+
+    _x2 = _x1;
+    _x1 = cCelsius;
+    _y2 = _y1;
+    _y1 = y;
+    return fromQ8(y);
+}
+
+void BiquadFilter::reset()
+{
+    _isInitialized = false;
+}
+
+void BiquadFilter::setCutoff(float fcToFs, float q)
+{
+    const double one = 16777216.0;                           // 1.0 in Q24
+    
+    if (! (fcToFs > 0.0f)) fcToFs = 0.001f;
+    if (fcToFs > 0.49f) fcToFs = 0.49f;
+    if (! (q > 0.0f)) q = 0.7071f;
+
+    double w0    = 2.0 * M_PI * fcToFs;
+    double alpha = sin(w0) / (2.0 * q);
+    double a0    = 1.0 + alpha;
+    double a1    = -2.0 * cos(w0) / a0;
+    double a2    = (1.0 - alpha) / a0;
+    double b0    = (1.0 - cos(w0)) / 2.0 / a0;
+
+    _a1 = (int32_t)lround(a1 * one);
+    _a2 = (int32_t)lround(a2 * one);
+    _b0 = (int32_t)lround(b0 * one);
+    _b2 = _b0;
+    _b1 = (int32_t)one + _a1 + _a2 - _b0 - _b2;              // sum(b) = 1 + a1 + a2, gain 1 at DC
+    _delay = (float)(1.0 - (a1 + 2.0 * a2) / (1.0 + a1 + a2));
+    reset();
+}
+
+float BiquadFilter::getGroupDelay()
+{
+    return _delay;
+}
+
+static int16_t applyBiquad(void *ctx, int16_t cCelsius)
+{
+    return static_cast<BiquadFilter *>(ctx)->apply(cCelsius);
+}
+
+Filter BiquadFilter::stage()
+{
+    return { applyBiquad, this };
+}
+
+/*
+ * ----------------------------- Kalman -----------------------------
+ */
+int16_t KalmanFilter::apply(int16_t cCelsius)
+{
+    int32_t x = (int32_t)cCelsius << 8;
+
+    if (! _isInitialized)
+    {
+        _y = x;
+        _isInitialized = true;
+    }
+    _y += (int32_t)(((int64_t)(x - _y) * _k + 32768) >> 16);
+    return fromQ8(_y);
+}
+
+void KalmanFilter::reset()
+{
+    _isInitialized = false;
+}
+
+void KalmanFilter::setNoise(float q, float r)
+{
+    double k = 1.0;                                          // no measurement noise: follow the input
+
+    if (q <= 0.0f) k = 0.0;                                  // constant temperature: keep the estimate
+    else if (r > 0.0f)
+    {
+        double m = (q + sqrt((double)q * q + 4.0 * q * r)) / 2.0;
+        k = m / (m + r);
+    }
+    _k = (uint32_t)lround(k * 65536.0);
+    if (_k == 0 && q > 0.0f) _k = 1;
+}
+
+float KalmanFilter::getGain()
+{
+    return _k / 65536.0f;
+}
+
+float KalmanFilter::getGroupDelay()
+{
+    return _k == 0 ? INFINITY : (65536.0f - _k) / _k;
+}
+
+static int16_t applyKalman(void *ctx, int16_t cCelsius)
+{
+    return static_cast<KalmanFilter *>(ctx)->apply(cCelsius);
+}
+
+Filter KalmanFilter::stage()
+{
+    return { applyKalman, this };
+}
+
+/*
+ * ------------------------------ Chain ------------------------------
+ */
+bool FilterChain::add(const Filter &stage, float delay)
+{
+    if (_count >= NTC_FILTER_STAGES || stage.apply == nullptr) return false;
+    _stages[_count++] = stage;
+    _delay += delay;
+    return true;
+}
+
+int16_t FilterChain::apply(int16_t cCelsius)
+{
+    for (uint8_t i = 0; i < _count; i++) cCelsius = _stages[i].apply(_stages[i].ctx, cCelsius);
+    return cCelsius;
+}
+
+float FilterChain::getGroupDelay()
+{
+    return _delay;
+}
+
+uint8_t FilterChain::getStages()
+{
+    return _count;
+}
+
+static int16_t applyChain(void *ctx, int16_t cCelsius)
+{
+    return static_cast<FilterChain *>(ctx)->apply(cCelsius);
+}
+
+Filter FilterChain::stage()
+{
+    return { applyChain, this };
+}
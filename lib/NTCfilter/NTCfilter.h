@@ -0,0 +1,102 @@
+/**
+ * Header       NTCfilter.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration of filters for the temperature in centi-°C which are put 
+ *              between NTCsensor and NTCthermostat to keep the ADC noise from switching 
+ *              the output. All filters work with integers and take the same time for 
+ *              each sample.
+ * 
+ *              EmaFilter       exponential moving average y += (x - y) / 2^shift
+ *              BiquadFilter    2nd order low-pass (Butterworth for q = 0.7071)
+ *              KalmanFilter    scalar Kalman filter for a slowly drifting temperature
+ *                              with process noise q and measurement noise r
+ *              FilterChain     up to NTC_FILTER_STAGES filters in series
+ * 
+ *              getGroupDelay() returns the delay of a filter for slow changes in samples.
+ *              Multiplied by the refresh interval it is the time the thermostat reacts 
+ *              later, so latency can be traded against noise. The first sample 
+ *              initializes a filter, so it starts without transient.
+ * 
+ * Usage        EmaFilter ema(2);                   // delay 3 samples
+ *              thermostat.setFilter(ema.stage());
+ */
+#ifndef _NTCFILTER_H_
+#define _NTCFILTER_H_
+#include <Arduino.h>
+#include "NTCthermostat.h"
+
+#ifndef NTC_FILTER_STAGES
+  #define NTC_FILTER_STAGES 3   // max. number of filters in a FilterChain
+#endif
+
+class EmaFilter
+{
+    public:
+        EmaFilter(uint8_t shift) { setShift(shift); }
+
+        int16_t apply(int16_t cCelsius);
+        void    reset();
+        void    setShift(uint8_t shift);   // 0 .. 8, alpha = 1 / 2^shift
+        float   getGroupDelay();           // 2^shift - 1 samples
+        Filter  stage();
+
+    private:
+        uint8_t _shift;
+        int32_t _y;                        // output in centi-°C * 256
+        bool    _isInitialized = false;
+};
+
+class BiquadFilter
+{
+    public:
+        BiquadFilter(float fcToFs, float q = 0.7071f) { setCutoff(fcToFs, q); }
+
+        int16_t apply(int16_t cCelsius);
+        void    reset();
+        void    setCutoff(float fcToFs, float q = 0.7071f);  // cutoff frequency / sample rate, < 0.5
+        float   getGroupDelay();
+        Filter  stage();
+
+    private:
+        int32_t _b0, _b1, _b2, _a1, _a2;   // Q24
+        int16_t _x1, _x2;                  // last inputs
+        int32_t _y1, _y2;                  // last outputs in centi-°C * 256
+        float   _delay;
+        bool    _isInitialized = false;
+};
+
+class KalmanFilter
+{
+    public:
+        KalmanFilter(float q, float r) { setNoise(q, r); }
+
+        int16_t apply(int16_t cCelsius);
+        void    reset();
+        void    setNoise(float q, float r);  // variances per sample in (centi-°C)^2
+        float   getGain();                   // steady state Kalman gain
+        float   getGroupDelay();             // (1 - K) / K samples
+        Filter  stage();
+
+    private:
+        uint32_t _k;                       // gain Q16
+        int32_t  _y;                       // estimate in centi-°C * 256
+        bool     _isInitialized = false;
+};
+
+class FilterChain
+{
+    public:
+        template <class F> bool add(F &filter)  { return add(filter.stage(), filter.getGroupDelay()); }
+        bool    add(const Filter &stage, float delay);
+        int16_t apply(int16_t cCelsius);
+        float   getGroupDelay();           // sum of the delays of all stages
+        uint8_t getStages();
+        Filter  stage();
+
+    private:
+        Filter  _stages[NTC_FILTER_STAGES];
+        uint8_t _count = 0;
+        float   _delay = 0.0f;
+};
+#endif
@@ -0,0 +1,198 @@
+/**
+ * Header       NTChistory.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration and implementation of the class template NTChistory, a 
+ *              statically allocated temperature history in three tiers:
+ * 
+ *              raw      the last RAW samples
+ *              minute   min / max / mean of the last MINUTES minutes
+ *              hour     min / max / mean of the last HOURS hours
+ * 
+ *              All temperatures are int16_t centi-°C. The rollups of the running minute
+ *              and hour are updated with each sample, so the min / max / mean of the hour
+ *              so far or of the last complete hour are answered in O(1) without rescan.
+ *              The tiers follow the wall clock: a minute or an hour without samples, e.g.
+ *              while the MCU sleeps, is stored as an empty rollup (min > max).
+ * 
+ * Template
+ * arguments    RAW, MINUTES, HOURS   capacities of the tiers, at most 255 each
+ *              RAM = 2 * RAW + 6 * (MINUTES + HOURS) + 32 bytes on AVR, checked at compile
+ *              time against NTC_HISTORY_MAX_BYTES, e.g. NTChistory<16, 60, 24> needs 568 bytes
+ * 
+ * Usage        history.push(reading.ms, reading.cCelsius);    // with each sample
+ *              Rollup h = history.getCurrent(HISTORY_HOUR);     // hour so far
+ *              Rollup l = history.getCompleted(HISTORY_HOUR);   // last complete hour
+ */
+#ifndef _NTCHISTORY_H_
+#define _NTCHISTORY_H_
+#include <Arduino.h>
+
+#ifndef NTC_HISTORY_MAX_BYTES
+  #define NTC_HISTORY_MAX_BYTES 768     // budget on AVR, checked at compile time
+#endif
+
+enum HistoryTier { HISTORY_MINUTE, HISTORY_HOUR };
+
+// min, max and mean in centi-°C, min > max if empty
+using Rollup = struct rollup { int16_t min; int16_t max; int16_t mean; };
+
+/**
+ * Running aggregate of a tier
+ */
+using Accumulator = struct accumulator { int16_t min; int16_t max; int32_t sum; uint16_t count; };
+
+template <uint8_t RAW, uint8_t MINUTES, uint8_t HOURS>
+class NTChistory
+{
+    static_assert(RAW > 0 && MINUTES > 0 && HOURS > 0, "capacities must not be 0");
+  #ifdef __AVR__
+    static_assert(2UL * RAW + 6UL * (MINUTES + HOURS) + 32UL <= NTC_HISTORY_MAX_BYTES, 
+                  "NTChistory exceeds NTC_HISTORY_MAX_BYTES");
+  #endif
+
+    public:
+        static const uint32_t msMinute = 60000UL;
+        static const uint8_t  minutesPerHour = 60;
+
+        NTChistory() { clear(); }
+
+        void clear()
+        {
+            _rawCount = _rawHead = 0;
+            _count[0] = _count[1] = _head[0] = _head[1] = 0;
+            _reset(_acc[0]);
+            _reset(_acc[1]);
+            _minutes = 0;
+            _started = false;
+        }
+
+        /**
+         * Add a sample taken at millis() ms
+         */
+        void push(uint32_t ms, int16_t cCelsius)
+        {
+            if (! _started)
+            {
+                _msMinute = ms;
+                _started  = true;
+            }
+            else if (ms - _msMinute >= msMinute)
+            {
+                _closeMinutes((ms - _msMinute) / msMinute);
+            }
+            _raw[_rawHead] = cCelsius;
+            _rawHead = (_rawHead + 1) % RAW;
+            if (_rawCount < RAW) _rawCount++;
+            _add(_acc[HISTORY_MINUTE], cCelsius, cCelsius, cCelsius, 1);
+        }
+
+        uint8_t getRawCount()          { return _rawCount; }
+        int16_t getRaw(uint8_t i = 0)  { return _raw[(_rawHead + RAW - 1 - i) % RAW]; }   // 0 = latest
+
+        // number of completed rollups of a tier
+        uint8_t getCount(HistoryTier tier)  { return _count[tier]; }
+
+        // running minute or hour including the running minute, O(1)
+        Rollup getCurrent(HistoryTier tier) 
+        { 
+            Accumulator acc = _acc[HISTORY_MINUTE];
+            if (tier == HISTORY_HOUR) _add(acc, _acc[HISTORY_HOUR].min, _acc[HISTORY_HOUR].max, _acc[HISTORY_HOUR].sum, _acc[HISTORY_HOUR].count);
+            return _rollup(acc); 
+        }
+
+        // completed minute or hour, 0 = latest, O(1)
+        Rollup getCompleted(HistoryTier tier, uint8_t i = 0)
+        {
+            uint8_t cap = tier == HISTORY_MINUTE ? MINUTES : HOURS;
+            Rollup *ring = tier == HISTORY_MINUTE ? _minuteRing : _hourRing;
+            if (i >= _count[tier]) return { INT16_MAX, INT16_MIN, 0 };
+            return ring[(_head[tier] + cap - 1 - i) % cap];
+        }
+
+        // the last n completed rollups of a tier combined, empty ones skipped, O(n)
+        Rollup getSummary(HistoryTier tier, uint8_t n)
+        {
+            Accumulator acc;
+            _reset(acc);
+            if (n > _count[tier]) n = _count[tier];
+            for (uint8_t i = 0; i < n; i++)
+            {
+                Rollup r = getCompleted(tier, i);
+                if (r.min <= r.max) _add(acc, r.min, r.max, r.mean, 1);
+            }
+            return _rollup(acc);
+        }
+
+    private:
+        int16_t     _raw[RAW];
+        Rollup      _minuteRing[MINUTES];
+        Rollup      _hourRing[HOURS];
+        Accumulator _acc[2];            // running minute and hour
+        uint8_t     _rawCount, _rawHead;
+        uint8_t     _count[2], _head[2];
+        uint8_t     _minutes;           // minutes in the running hour
+        bool        _started;
+        uint32_t    _msMinute;          // start of the running minute
+
+        static void _reset(Accumulator &acc) { acc = { INT16_MAX, INT16_MIN, 0, 0 }; }
+
+        static void _add(Accumulator &acc, int16_t min, int16_t max, int32_t sum, uint16_t count)
+        {
+            if (min < acc.min) acc.min = min;
+            if (max > acc.max) acc.max = max;
+            acc.sum   += sum;
+            acc.count += count;
+        }
+
+        static Rollup _rollup(const Accumulator &acc)
+        {
+            int16_t mean = acc.count ? (int16_t)(acc.sum / (int32_t)acc.count) : 0;
+            return { acc.min, acc.max, mean };
+        }
+
+        void _store(HistoryTier tier, Rollup *ring, uint8_t cap, const Rollup &r)
+        {
+            ring[_head[tier]] = r;
+            _head[tier] = (_head[tier] + 1) % cap;
+            if (_count[tier] < cap) _count[tier]++;
+        }
+
+        /**
+         * elapsed minutes have passed, the first holds the samples of the running
+         * minute, the others are empty. A gap longer than all tiers only empties
+         * them, the hour keeps its phase.
+         */
+        void _closeMinutes(uint32_t elapsed)
+        {
+            const uint32_t all = (HOURS + 1UL) * minutesPerHour + MINUTES;
+
+            _msMinute += elapsed * msMinute;                // stay aligned to the first sample
+            _closeMinute();
+            elapsed--;
+            if (elapsed > all)
+            {
+                _minutes = (_minutes + (elapsed - all)) % minutesPerHour;
+                elapsed  = all;
+            }
+            while (elapsed-- > 0) _closeMinute();
+        }
+
+        /**
+         * The running minute is complete. Its samples are added to the 
+         * running hour, so the mean of the hour is weighted by samples.
+         */
+        void _closeMinute()
+        {
+            Accumulator &m = _acc[HISTORY_MINUTE];
+            _store(HISTORY_MINUTE, _minuteRing, MINUTES, _rollup(m));
+            _add(_acc[HISTORY_HOUR], m.min, m.max, m.sum, m.count);
+            _reset(m);
+            if (++_minutes < minutesPerHour) return;
+            _store(HISTORY_HOUR, _hourRing, HOURS, _rollup(_acc[HISTORY_HOUR]));
+            _reset(_acc[HISTORY_HOUR]);
+            _minutes = 0;
+        }
+};
+
+#endif
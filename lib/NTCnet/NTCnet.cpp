@@ -0,0 +1,239 @@
+/**
+ * Class        NTCnet.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class NTCnet, see NTCnet.h
+ *
+ *              The queue has one writer, push() in the loop, and one reader, the poster.
+ *              On the ESP32 they run on different cores, the SpscQueue needs no lock. A
+ *              batch is peeked, encoded and posted and only dropped from the queue after 
+ *              the server has accepted it. New limits are guarded by a spinlock: the 
+ *              poster stores both and sets a flag, loop() takes both and sets them 
+ *              between two calls of NTCthermostat::loop(), so the thermostat never sees 
+ *              one limit without the other.
+ *
+ * Board        Wemos D1 R2, ESP32 DevKit V1
+ */
+
+#include "NTCnet.h"
+
+#if defined(ESP32) || defined(ESP8266)
+
+void NTCnet::begin()
+{
+  #ifdef ESP32
+    xTaskCreatePinnedToCore(_task, "NTCnet", 4096, this, 1, nullptr, NTC_NET_CORE);
+  #endif
+}
+
+/**
+ * Called with each sample, returns at once
+ */
+bool NTCnet::push(const Reading &r)
+{
+    if (_queue.push({ r.ms, r.cCelsius, (uint8_t)(_thermostat.isOutputOn() ? 1 : 0) })) return true;
+    _dropped++;
+    return false;
+}
+
+/**
+ * Apply new limits. On the ESP8266 a due batch is posted if the
+ * thermostat is idle for longer than the connection may take.
+ */
+void NTCnet::loop(uint32_t msBudget)
+{
+    if (_hasLimits)
+    {
+        _lock();
+        int16_t cLow  = _cLow;
+        int16_t cHigh = _cHigh;
+        _hasLimits = false;
+        _unlock();
+        _thermostat.setLimitLow(cLow / 100.0f);
+        _thermostat.setLimitHigh(cHigh / 100.0f);
+        _limitChanges++;
+    }
+  #ifdef ESP8266
+    if (msBudget > 3UL * NTC_NET_TIMEOUT && _isDue()) _post();
+  #else
+    (void)msBudget;
+  #endif
+}
+
+uint32_t NTCnet::getPosted()
+{
+    return _posted;
+}
+
+uint32_t NTCnet::getDropped()
+{
+    return _dropped;
+}
+
+uint32_t NTCnet::getErrors()
+{
+    return _errors;
+}
+
+uint32_t NTCnet::getLimitChanges()
+{
+    return _limitChanges;
+}
+
+#ifdef ESP32
+void NTCnet::_task(void *ctx)
+{
+    NTCnet &net = *static_cast<NTCnet *>(ctx);
+    for (;;)
+    {
+        if (net._isDue()) net._post();
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+#endif
+
+/**
+ * A full batch or an old sample, WiFi connected and no back-off
+ */
+bool NTCnet::_isDue()
+{
+    uint32_t msNow = millis();
+
+    if (_isBackoff && (int32_t)(msNow - _msRetry) < 0) return false;
+    if (WiFi.status() != WL_CONNECTED) return false;
+    NetSample oldest;
+    if (_queue.count() >= NTC_NET_BATCH) return true;
+    return _queue.peek(0, oldest) && msNow - oldest.ms >= NTC_NET_PERIOD;
+}
+
+bool NTCnet::_post()
+{
+    char     body[NTC_NET_BATCH * 28 + 96];
+    char     head[160];
+    uint8_t  n   = _queue.count();
+
+    if (n > NTC_NET_BATCH) n = NTC_NET_BATCH;
+    uint16_t len = _encode(body, sizeof(body), n);
+    snprintf(head, sizeof(head), "POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: application/json\r\n"
+                                 "Content-Length: %u\r\nConnection: close\r\n\r\n", _path, _host, len);
+  #ifdef ESP32
+    bool isOk = _client.connect(_host, _port, NTC_NET_TIMEOUT);
+  #else
+    _client.setTimeout(NTC_NET_TIMEOUT);
+    bool isOk = _client.connect(_host, _port);
+  #endif
+    if (isOk)
+    {
+        _client.print(head);
+        _client.write((const uint8_t *)body, len);
+        isOk = _readAnswer();
+    }
+    _client.stop();
+    if (! isOk)
+    {
+        _errors++;
+        _isBackoff = true;
+        _msRetry   = millis() + NTC_NET_BACKOFF;
+        return false;
+    }
+    _queue.drop(n);
+    _posted   += n;
+    _isBackoff = false;
+    return true;
+}
+
+/**
+ * JSON of the n oldest samples
+ */
+uint16_t NTCnet::_encode(char *buf, uint16_t size, uint8_t n)
+{
+    NetSample sample;
+
+    int len = snprintf(buf, size, "{\"node\":\"%s\",\"low\":%d,\"high\":%d,\"samples\":[",
+                       _node, _thermostat.getCentiLimitLow(), _thermostat.getCentiLimitHigh());
+    for (uint8_t i = 0; i < n && len < size && _queue.peek(i, sample); i++)
+    {
+        len += snprintf(buf + len, size - len, "%s[%lu,%d,%u]", i > 0 ? "," : "",
+                        (unsigned long)sample.ms, sample.cCelsius, sample.on);
+    }
+    if (len < size) len += snprintf(buf + len, size - len, "]}");
+    return len < size ? len : size - 1;
+}
+
+/**
+ * Status line 2xx, the body may carry new limits
+ */
+bool NTCnet::_readAnswer()
+{
+    char     line[48];
+    uint8_t  len    = 0;
+    bool     isBody = false;
+    bool     isOk   = false;
+    bool     isFirst = true;
+    uint32_t msStart = millis();
+
+    while (millis() - msStart < NTC_NET_TIMEOUT)
+    {
+        if (_client.available() <= 0)
+        {
+            if (! _client.connected()) break;
+            delay(1);                                            // let the WiFi stack run
+            continue;
+        }
+        char c = _client.read();
+        if (isBody)
+        {
+            if (len < sizeof(line) - 1) line[len++] = c;
+            continue;
+        }
+        if (c == '\r') continue;
+        if (c != '\n')
+        {
+            if (len < sizeof(line) - 1) line[len++] = c;
+            continue;
+        }
+        line[len] = '\0';
+        if (isFirst) isOk = strncmp(line, "HTTP/1.", 7) == 0 && len >= 12 && line[9] == '2';
+        isFirst = false;
+        isBody  = len == 0;                                      // empty line ends the header
+        len     = 0;
+    }
+    line[len] = '\0';
+    if (isOk && isBody && len > 0) _parseLimits(line);
+    return isOk;
+}
+
+/**
+ * low=20.5&high=21.5, both or none, low < high
+ */
+void NTCnet::_parseLimits(const char *body)
+{
+    const char *low  = strstr(body, "low=");
+    const char *high = strstr(body, "high=");
+
+    if (low == nullptr || high == nullptr) return;
+    float   tLow  = atof(low + 4);
+    float   tHigh = atof(high + 5);
+    if (! (tLow >= -40.0f && tHigh <= 125.0f && tLow < tHigh)) return;
+    _lock();
+    _cLow      = (int16_t)lroundf(tLow * 100.0f);
+    _cHigh     = (int16_t)lroundf(tHigh * 100.0f);
+    _hasLimits = true;
+    _unlock();
+}
+
+void NTCnet::_lock()
+{
+  #ifdef ESP32
+    portENTER_CRITICAL(&_mux);
+  #endif
+}
+
+void NTCnet::_unlock()
+{
+  #ifdef ESP32
+    portEXIT_CRITICAL(&_mux);
+  #endif
+}
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * Header       NTCnet.h
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Declaration of the class NTCnet, the network telemetry of the thermostat on
+ *              the ESP32 and the ESP8266. The samples are queued without waiting and posted
+ *              in batches as JSON to an HTTP server. The answer of the server may carry new
+ *              limits, which are applied to the thermostat both at once by loop().
+ *
+ *              ESP32    the batches are posted by a FreeRTOS task on NTC_NET_CORE, by default
+ *                       the core which NTCdualCore does not use for the control, core 0 of
+ *                       the WiFi stack. The Arduino loop on core 1 never waits for the network.
+ *              ESP8266  there is only one core. loop(msBudget) posts a batch only if the
+ *                       thermostat has nothing to do for longer than NTC_NET_TIMEOUT, which
+ *                       bounds each blocking step of the connection, so a stalled network
+ *                       never delays a tick.
+ *
+ * Usage        NTCnet net(thermostat, "192.168.1.10", 8080, "/ntc", "living-room");
+ *              setup()        WiFi.begin(ssid, password); net.begin();
+ *              processData()  net.push(reading);
+ *              loop()         net.loop(thermostat.msUntilDue(millis()));
+ *
+ * Request      POST <path> HTTP/1.1, Content-Type: application/json
+ *              {"node":"living-room","low":2100,"high":2200,"samples":[[ms,cCelsius,on],...]}
+ *              temperatures and limits in centi-°C
+ *
+ * Answer       status 2xx and optionally a body  low=20.5&high=21.5  with new limits in °C.
+ *              The batch is only removed from the queue after a 2xx answer.
+ */
+#ifndef _NTCNET_H_
+#define _NTCNET_H_
+#include <Arduino.h>
+
+#if defined(ESP32) || defined(ESP8266)
+#ifdef ESP32
+  #include <WiFi.h>
+#else
+  #include <ESP8266WiFi.h>
+#endif
+#include "NTCsensor.h"
+#include "NTCthermostat.h"
+#include "SpscQueue.h"
+
+#ifndef NTC_NET_QUEUE
+  #define NTC_NET_QUEUE    64       // samples queued, must be a power of 2
+#endif
+#ifndef NTC_NET_BATCH
+  #define NTC_NET_BATCH    16       // samples posted at once
+#endif
+#ifndef NTC_NET_PERIOD
+  #define NTC_NET_PERIOD   60000    // ms after which an incomplete batch is posted
+#endif
+#ifndef NTC_NET_TIMEOUT
+  #define NTC_NET_TIMEOUT  1000     // ms for the connection and for the answer
+#endif
+#ifndef NTC_CORE_CONTROL
+  #define NTC_CORE_CONTROL 1        // core of the control task of NTCdualCore
+#endif
+#ifndef NTC_NET_CORE
+  #define NTC_NET_CORE     (NTC_CORE_CONTROL == 0 ? 1 : 0)  // core of the poster task
+#endif
+#ifndef NTC_NET_BACKOFF
+  #define NTC_NET_BACKOFF  10000    // ms to wait after a failed post
+#endif
+
+// Queued sample, on = state of the output
+using NetSample = struct netSample { uint32_t ms; int16_t cCelsius; uint8_t on; };
+
+class NTCnet
+{
+    public:
+        NTCnet(NTCthermostat &thermostat, const char *host, uint16_t port, const char *path, const char *node) :
+               _thermostat(thermostat), _host(host), _port(port), _path(path), _node(node) {}
+
+        void     begin();                       // ESP32: starts the task
+        bool     push(const Reading &r);        // queue a sample, false if the queue is full
+        void     loop(uint32_t msBudget = 0);   // applies new limits, ESP8266: posts if msBudget allows
+        uint32_t getPosted();                   // samples posted
+        uint32_t getDropped();                  // samples dropped because the queue was full
+        uint32_t getErrors();                   // failed posts
+        uint32_t getLimitChanges();             // limits received from the server
+
+    private:
+        NTCthermostat &_thermostat;
+        const char *_host;
+        uint16_t    _port;
+        const char *_path;
+        const char *_node;
+        WiFiClient  _client;
+
+        SpscQueue<NetSample, NTC_NET_QUEUE> _queue;  // push() produces, the poster consumes
+        uint32_t    _msRetry   = 0;             // no post before this time after an error
+        bool        _isBackoff = false;
+
+        volatile bool _hasLimits = false;       // limits received, not applied yet
+        int16_t     _cLow;
+        int16_t     _cHigh;
+
+        uint32_t    _posted = 0;
+        uint32_t    _dropped = 0;
+        uint32_t    _errors = 0;
+        uint32_t    _limitChanges = 0;
+
+      #ifdef ESP32
+        portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+        static void _task(void *ctx);
+      #endif
+
+        bool     _isDue();
+        bool     _post();                       // post one batch, true on success
+        uint16_t _encode(char *buf, uint16_t size, uint8_t n);
+        bool     _readAnswer();
+        void     _parseLimits(const char *body);
+        void     _lock();
+        void     _unlock();
+};
+
+#endif
+#endif
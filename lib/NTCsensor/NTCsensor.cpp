@@ -60,6 +60,53 @@
  *              Rt   = Rs * (Amax - Aval) / Aval     NTC to Vcc
  *                   = Rs * k                        k = (Amax / Aval) -  1
  *  
+ * Steinhart-  1/T  = A + B * ln(Rt) + C * ln(Rt)^3            T in K, Rt in Ohm
+ * Hart        
+ *              The Beta formula is the special case C = 0. With the third coefficient the 
+ *              model fits a real NTC over a wide range, the Beta model deviates by a degree 
+ *              and more away from To. A, B and C are calculated from 3 points (T1, R1), 
+ *              (T2, R2), (T3, R3), e.g. from the datasheet or a calibration, with
+ *              Li = ln(Ri), Yi = 1/Ti:
+ * 
+ *              g2 = (Y2 - Y1) / (L2 - L1)     g3 = (Y3 - Y1) / (L3 - L1)
+ *              C  = (g3 - g2) / (L3 - L2) / (L1 + L2 + L3)
+ *              B  = g2 - C * (L1^2 + L1 * L2 + L2^2)
+ *              A  = Y1 - (B + C * L1^2) * L1
+ * 
+ *              ln(Rt) is approximated by splitting Rt = m * 2^e with m in [1/√2, √2) and 
+ *              ln(m) = 2 * atanh(s), s = (m - 1) / (m + 1), |s| < 0.172, with 4 terms of 
+ *              the series. The error is below 3e-8, i.e. less than 1e-6 °C, at the cost 
+ *              of one division and 7 multiplications instead of a call to log().
+ * 
+ * Lookup table Instead of calculating log() for each sample, the temperature can be interpolated 
+ *              linearly from a table T[i] of centi-°C at the analog values i * h, h = 2^shift.
+ *              The interpolation error is bounded by 
+ * 
+ *                  |e| <= h^2 / 8 * max|T''(A)|      
+ * 
+ *              where T''(A) is the curvature of the temperature over the analog value. It grows
+ *              towards the ends of the ADC range, so buildLookupTable() measures the largest 
+ *              deviation from the Beta formula for all analog values in the range NTC_LUT_TMIN .. 
+ *              NTC_LUT_TMAX and returns it, rounding to 0.01 °C included. For the Elegoo module 
+ *              (Rs 10k, Ro 10k, B 2800) on the Uno the maximum errors are:
+ * 
+ *              entries  h     0 .. 50 °C   -40 .. 125 °C
+ *                 65   16     0.015 °C      0.31 °C
+ *                129    8     0.011 °C      0.07 °C
+ *                257    4     0.011 °C      0.02 °C
+ * 
+ * Fixed point  With NTC_FIXED_POINT the Beta formula is evaluated in the log2 domain with integers
+ *              only. With A = Amax * 2^extraBits and all voltages in mV:
+ * 
+ *              vinA = Voff * A + Aval * (Vref - Voff)        Vin * A
+ *              L2   = ± (log2(vinA) - log2(Vcc * A - vinA))  log2(k), - for NTC to Vcc 
+ *                     + log2(Rs / Ro) + BETA / (To * ln2)    = log2(Rt / Roo)
+ *              T    = (BETA / ln2) / L2
+ * 
+ *              log2() is calculated in Q16 from the position of the highest bit and a table
+ *              of 32 entries for the mantissa with linear interpolation (error < 2e-4). 
+ *              This keeps the temperature within 0.01 °C of the floating point result. 
+ * 
  * References   http://www.resistorguide.com/ntc-thermistor/#Voltage-current_characteristic
  * 
  * Attention 🔴 To be able to use snprintf() with float format for the Arduino uno, the following flags 
@@ -69,66 +116,954 @@
 #include "NTCsensor.h"
 
 /**
- * Read sensor and update calculated values
+ * ln(x) for x > 0, see Steinhart-Hart above
+ */
+static double fastLn(double x)
+{
+    int    e;
+    double m = frexp(x, &e);                                 // x = m * 2^e, m in [0.5, 1)
+
+    if (m < M_SQRT1_2) { m *= 2.0; e--; }                    // m in [1/√2, √2)
+    double s  = (m - 1.0) / (m + 1.0);
+    double s2 = s * s;
+    return e * M_LN2 + 2.0 * s * (1.0 + s2 * (1.0 / 3.0 + s2 * (1.0 / 5.0 + s2 * (1.0 / 7.0))));
+}
+
+#ifdef NTC_FIXED_POINT
+// log2(1 + i/32) in Q16
+static const uint16_t log2Table[32] PROGMEM = {
+        0,  2909,  5732,  8473, 11136, 13727, 16248, 18704, 21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346, 
+    38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207, 52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047 
+};
+
+/**
+ * log2(x) in Q16 for x > 0
+ */
+static int32_t log2Q16(uint32_t x)
+{
+    int32_t n = 31;
+
+    while ((x & 0x80000000UL) == 0) { x <<= 1; n--; }       // normalize to 1.f * 2^n
+    uint8_t  i    = (x >> 26) & 0x1F;                        // 5 bits of f index the table
+    uint32_t frac = (x >> 10) & 0xFFFF;                      // next 16 bits interpolate
+    int32_t  y0   = pgm_read_word(&log2Table[i]);
+    int32_t  y1   = i < 31 ? (int32_t)pgm_read_word(&log2Table[i + 1]) : 65536L;
+    return (n << 16) + y0 + (int32_t)(((y1 - y0) * frac) >> 16);
+}
+
+/**
+ * Integer constants of the Beta formula. The ADC voltages are rounded to mV.
+ */
+void NTCsensor::_initFixedPoint()
+{
+    _fxVoff = (int32_t)lround(_vOff);
+    _fxSpan = (int32_t)lround(_vOff + _v * _adc.Amax) - _fxVoff;
+    _fxVcc  = (int32_t)lround(_vcc);
+    _fxB    = (uint32_t)_ntc.beta * 94548UL + (uint32_t)_ntc.beta * 4606UL / 10000UL;  // 2^16 / ln2 = 94548.4606
+    _fxC2   = log2Q16(_ntc.Rs) - log2Q16(_ntc.Ro)
+            + (int32_t)((_fxB / 29815UL) * 100UL + (_fxB % 29815UL) * 100UL / 29815UL);  // B / 298.15 K
+}
+
+/**
+ * Temperature in centi-°C for the analog value aval scaled by 2^bits, 
+ * clipped to the range of int16_t
  */
-void NTCsensor::_readSensor()
+int16_t NTCsensor::_fxCenti(uint32_t aval, uint8_t bits)
 {
-    _analogValue = analogRead(_adc.pin);
-    _v = (_adc.Vref - _adc.Voff) / (double)_adc.Amax;
-    _vin = (_analogValue * _v) + _adc.Voff;
-    _k = _vin / ( _adc.Vcc - _vin);
+    int32_t a    = (int32_t)_adc.Amax << bits;
+    int32_t vinA = _fxVoff * a + (int32_t)aval * _fxSpan;
+    int32_t denA = _fxVcc * a - vinA;
+
+    if (vinA <= 0) return _adc.ntcToGround ? INT16_MAX : INT16_MIN;   // Rt = 0 or Rt --> oo
+    if (denA <= 0) return _adc.ntcToGround ? INT16_MIN : INT16_MAX;
+
+    int32_t l2 = log2Q16(vinA) - log2Q16(denA);
+    if (_adc.ntcToGround == false) l2 = -l2;
+    l2 += _fxC2;
+    if (l2 <= 0) return INT16_MAX;                                    // hotter than T --> oo
+
+    uint32_t q = _fxB / (uint32_t)l2;                                 // T in K 
+    uint32_t r = _fxB % (uint32_t)l2;
+    int32_t  c = (int32_t)(q * 100UL + r * 100UL / (uint32_t)l2) - 27315L;
+    if (c > INT16_MAX) return INT16_MAX;
+    return (int16_t)c;
+}
+#endif
+
+/**
+ * Calculate the constants from the parameters, the built-in ADC 
+ * is set up again with the next conversion
+ */
+void NTCsensor::reconfigure()
+{
+    _isAdcReady = false;
+    _Roo = _ntc.Ro * exp(-(double)_ntc.beta / (_To - _Tabs)); // calculate the resistance of the NTC for T --> oo
+    _v    = (_adc.Vref - _adc.Voff) / (double)_adc.Amax;         // volts per ADC step
+    _vOff = _adc.Voff;
+    _vcc  = _adc.Vcc;
+    _isSH = _ntc.sh != nullptr;
+    if (_isSH)
+    {
+        _shA = _ntc.sh->A;
+        _shB = _ntc.sh->B;
+        _shC = _ntc.sh->C;
+    }
+    #ifdef ESP32
+      if (_rangeCount > 0) _applyRange(*_ranges[_range]);  // keep the auto-range
+      else _applyCurve(_adc.att);
+    #endif
+    #ifdef NTC_SUPPLY
+      _applySupply();                                      // keep the last measurement
+    #endif
+    _initOversampling();
+    #ifdef NTC_FIXED_POINT
+      _initFixedPoint();
+    #endif
+    if (_lut.table != nullptr && _paramsHash() != _lutParams)   // table of other parameters
+    {
+        if (_lutBuffer != nullptr) buildLookupTable(_lutBuffer, _lut.size);
+        else _lut = {};
+    }
+}
+
+/**
+ * FNV-1a over the parameters of the conversion, not over the 
+ * supply, which the table compensates at runtime
+ */
+static void hashBytes(uint32_t &h, const void *data, size_t size)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    while (size-- > 0) h = (h ^ *p++) * 16777619UL;
+}
+
+uint32_t NTCsensor::_paramsHash()
+{
+    uint32_t h = 2166136261UL;
+
+    hashBytes(h, &_ntc.Rs, sizeof(_ntc.Rs));
+    hashBytes(h, &_ntc.Ro, sizeof(_ntc.Ro));
+    hashBytes(h, &_ntc.beta, sizeof(_ntc.beta));
+    if (_ntc.sh != nullptr) hashBytes(h, _ntc.sh, sizeof(ParamsSH));
+    hashBytes(h, &_adc.ntcToGround, sizeof(_adc.ntcToGround));
+    hashBytes(h, &_adc.Amax, sizeof(_adc.Amax));
+    hashBytes(h, &_adc.Vcc, sizeof(_adc.Vcc));
+    hashBytes(h, &_adc.Vref, sizeof(_adc.Vref));
+    hashBytes(h, &_adc.Voff, sizeof(_adc.Voff));
+    return h;
+}
+
+/**
+ * Check the oversampling parameters.
+ * The number of conversions must be at least 4^extraBits, the median 
+ * is limited to NTC_MEDIAN_MAX conversions and the scaled analog 
+ * value must fit into 16 bits.
+ */
+void NTCsensor::_initOversampling()
+{
+    ParamsOVS *ovs = _adc.ovs;
+    if (ovs != nullptr)
+    {
+        _ovsBits = ovs->extraBits;
+        if (ovs->reject == OVS_MEDIAN) _ovsBits = 0;           // the median gains no resolution
+        while (_ovsBits > 0 && ((uint32_t)_adc.Amax << _ovsBits) > 0xFFFF) _ovsBits--;
+        _ovsSamples = ovs->samples;
+        if (_ovsSamples < (1u << (2 * _ovsBits))) _ovsSamples = 1u << (2 * _ovsBits);
+        if (ovs->reject == OVS_TRIMMED && _ovsSamples < 3) _ovsSamples = 3;
+        if (ovs->reject == OVS_MEDIAN && _ovsSamples > NTC_MEDIAN_MAX) _ovsSamples = NTC_MEDIAN_MAX;
+        if (_ovsSamples == 0) _ovsSamples = 1;
+    }
+    _rawStep = 1.0 / (double)(1u << _ovsBits);
+    startSampling();
+}
+
+/**
+ * Add one conversion to the current block
+ */
+void NTCsensor::_accumulate(uint16_t aval)
+{
+    if (_adc.ovs->reject == OVS_MEDIAN)
+    {
+        uint16_t i = _ovsCount;                                  // insertion sort, at most NTC_MEDIAN_MAX steps
+        for (; i > 0 && _ovsSorted[i - 1] > aval; i--) _ovsSorted[i] = _ovsSorted[i - 1];
+        _ovsSorted[i] = aval;
+    }
+    _ovsSum += aval;
+    if (aval < _ovsMin) _ovsMin = aval;
+    if (aval > _ovsMax) _ovsMax = aval;
+    _ovsCount++;
+}
+
+/**
+ * Analog value of a completed block, scaled by 2^extraBits
+ * raw = sum * 2^extraBits / n   (equals sum >> extraBits for n = 4^extraBits)
+ */
+uint16_t NTCsensor::_blockValue()
+{
+    uint32_t sum = _ovsSum;
+    uint16_t n   = _ovsCount;
+
+    switch (_adc.ovs->reject)
+    {
+        case OVS_MEDIAN:
+            return _ovsSorted[n / 2];
+        case OVS_TRIMMED:
+            sum -= (uint32_t)_ovsMin + _ovsMax;
+            n   -= 2;
+            break;
+        default:
+            break;
+    }
+    return ((sum << _ovsBits) + n / 2) / n;
+}
+
+double NTCsensor::_vinOf(double aval)
+{
+    return (aval * _v) + _vOff;
+}
+
+double NTCsensor::_rtOf(double vin)
+{
+    _k = vin < _vcc ? vin / ( _vcc - vin) : INFINITY;
     if (_adc.ntcToGround == false) _k = 1.0 / _k;
-    _Rt = (double)_ntc.Rs * _k;
-    _tKelvin = (double)_ntc.beta / log(_Rt/_Roo);  // Calculate  T from Rt, Roo and BETA
-    _tCelsius = _tKelvin + _Tabs;                  // Convert Kelvin to Celcius
-    _tFahrenheit = _tCelsius * 9.0 / 5.0 + 32.0;   // Convert Celcius to Fahrenheit 
+    return (double)_ntc.Rs * _k;
+}
+
+/**
+ * Temperature in °C at the resistance rt with the Beta formula or the 
+ * Steinhart-Hart model, +inf if rt is too small for the model
+ */
+double NTCsensor::_celsiusOf(double rt)
+{
+    if (_isSH)
+    {
+        if (! (rt > 0.0)) return INFINITY;
+        double x    = fastLn(rt);
+        double invT = _shA + x * (_shB + _shC * x * x);
+        return invT > 0.0 ? 1.0 / invT + _Tabs : INFINITY;
+    }
+    if (! (rt > _Roo)) return INFINITY;                           // hotter than T --> oo
+    return (double)_ntc.beta / log(rt/_Roo) + _Tabs;
+}
+
+/**
+ * Temperature in centi-°C at the resistance rt, clipped to the range of int16_t
+ */
+int16_t NTCsensor::_centiOf(double rt)
+{
+    return _toCenti(_celsiusOf(rt));
+}
+
+int16_t NTCsensor::_toCenti(double celsius)
+{
+    double c = celsius * 100.0;
+    if (! (c < (double)INT16_MAX)) return INT16_MAX;              // includes NaN
+    if (c <= (double)INT16_MIN) return INT16_MIN;
+    return (int16_t)lround(c);
+}
+
+/**
+ * Interpolate the temperature from the table. With oversampling 
+ * the extra bits of raw are used for the interpolation.
+ */
+int16_t NTCsensor::_lookup(uint16_t raw)
+{
+    uint8_t  shift = _lut.shift + _ovsBits;
+    uint16_t i     = raw >> shift;
+    uint16_t frac  = raw & ((1u << shift) - 1);
+    int16_t  t0, t1;
+
+    if (i >= _lut.size - 1) i = _lut.size - 1, frac = 0;
+    if (_lut.inProgmem)
+    {
+        t0 = (int16_t)pgm_read_word(&_lut.table[i]);
+        t1 = frac ? (int16_t)pgm_read_word(&_lut.table[i + 1]) : t0;
+    }
+    else
+    {
+        t0 = _lut.table[i];
+        t1 = frac ? _lut.table[i + 1] : t0;
+    }
+    return t0 + (int16_t)(((int32_t)(t1 - t0) * frac) >> shift);
+}
+
+double NTCsensor::_rawToAval(uint16_t raw)
+{
+    return raw * _rawStep;
+}
+
+/**
+ * The table is calculated for the nominal supply, with a measured supply
+ * raw is scaled to the value it would have at the nominal one. Exact for 
+ * Voff = 0.
+ */
+uint16_t NTCsensor::_lutRaw(uint16_t raw)
+{
+#ifdef NTC_SUPPLY
+    if (_lutScale != 0x8000)
+    {
+        uint32_t r = ((uint32_t)raw * _lutScale + 0x4000) >> 15;
+        return r > 0xFFFF ? 0xFFFF : (uint16_t)r;
+    }
+#endif
+    return raw;
+}
+
+/**
+ * Update the calculated values from the analog value raw
+ */
+void NTCsensor::_convert(uint16_t raw)
+{
+#ifdef NTC_STATS
+    uint32_t usStart = micros();
+#endif
+    _reading.ms  = millis();
+    _reading.raw = raw;
+#ifdef ESP32
+    raw = _curveRaw(raw);                                            // characteristic of the attenuation
+#endif
+#ifdef NTC_FIXED_POINT
+    if (_lut.table != nullptr) _reading.cCelsius = _lookup(_lutRaw(raw));
+    else if (_isSH)            _reading.cCelsius = _centiOf(_rtOf(_vinOf(_rawToAval(raw))));
+    else                       _reading.cCelsius = _fxCenti(raw, _ovsBits);
+#else
+    if (_lut.table != nullptr)
+    {
+        _reading.cCelsius = _lookup(_lutRaw(raw));
+        _reading.celsius  = _reading.cCelsius / 100.0;
+        _reading.vin      = NAN;                                     // calculated on demand
+        _reading.Rt       = NAN;
+    }
+    else
+    {
+        _reading.vin = _vinOf(_rawToAval(raw));
+        _reading.Rt  = _rtOf(_reading.vin);
+        _reading.celsius  = _celsiusOf(_reading.Rt);                 // Calculate T from Rt with Beta or Steinhart-Hart
+        _reading.cCelsius = _toCenti(_reading.celsius);
+    }
+    _reading.kelvin = _reading.celsius - _Tabs;                      // Convert Celcius to Kelvin
+    _reading.fahrenheit = _reading.celsius * 9.0 / 5.0 + 32.0;       // Convert Celcius to Fahrenheit 
+#endif
+#ifdef NTC_STATS
+    uint32_t us = micros() - usStart;
+    _stats.samples++;
+    _stats.usConvert += us;
+    if (us > _stats.usConvertMax) _stats.usConvertMax = us;
+#endif
+}
+
+void NTCsensor::startSampling()
+{
+    _ovsCount = 0;
+    _ovsSum   = 0;
+    _ovsMin   = 0xFFFF;
+    _ovsMax   = 0;
+}
+
+/**
+ * Make one conversion. Returns true when the sample is complete
+ * and the calculated values have been updated. With a source set,
+ * all conversions available from the source are consumed until 
+ * the sample is complete.
+ */
+bool NTCsensor::update()
+{
+    if (_source.read != nullptr)
+    {
+        if (! _source.isBuffered)
+        {
+            AdcFromSource<false> adc(_source);
+            return update(adc);
+        }
+        AdcFromSource<true> adc(_source);
+        return update(adc);
+    }
+    if (! _isAdcReady) _beginAdc();
+  #ifdef ESP32
+    bool isRanging = _isRanging();
+    if (isRanging) _beginSample();
+  #endif
+  #ifdef NTC_SUPPLY
+    if (_supplyEvery > 0 && _ovsCount == 0 && _supplySamples >= _supplyEvery)   // between two samples
+    {
+        _measureSupply();
+        return false;
+    }
+  #endif
+    AdcBuiltin adc(_adc);
+    if (! update(adc)) return false;
+  #ifdef NTC_SUPPLY
+    if (_supplyEvery > 0) _supplySamples++;
+  #endif
+  #ifdef ESP32
+    if (isRanging) _autoRange(_curveRaw(_reading.raw));
+  #endif
+    return true;
+}
+
+void NTCsensor::_beginAdc()
+{
+    AdcBuiltin(_adc).begin();
+    #ifdef ESP32
+      if (_rangeCount > 0) _applyRange(*_ranges[_range]);  // per pin, after the global attenuation
+      if (_supplyEvery > 0) analogSetPinAttenuation(_pinSupply, ADC_11db);
+    #endif
+    _isAdcReady = true;
+}
+
+void NTCsensor::setSource(const AdcSource &source)
+{
+    _source = source;
+    startSampling();
+}
+
+/**
+ * Add a conversion which was made elsewhere, e.g. on another pin
+ * with the same NTC and ADC parameters. Returns true when the 
+ * sample is complete.
+ */
+bool NTCsensor::add(uint16_t aval)
+{
+#ifdef NTC_STATS
+    _stats.conversions++;
+#endif
+    if (_adc.ovs == nullptr)
+    {
+        _convert(aval);
+        return true;
+    }
+    _accumulate(aval);
+    if (_ovsCount < _ovsSamples) return false;
+    _convert(_blockValue());
+    startSampling();
+    return true;
+}
+
+/**
+ * Without NTC_STATS the sensor has no counters
+ */
+SensorStats NTCsensor::getStats()
+{
+#ifdef NTC_STATS
+    return _stats;
+#else
+    SensorStats stats = {};
+    return stats;
+#endif
+}
+
+void NTCsensor::resetStats()
+{
+#ifdef NTC_STATS
+    _stats = {};
+#endif
+}
+
+bool NTCsensor::isOversampling()
+{
+    return _ovsSamples > 1;
+}
+
+/**
+ * Read the sensor. All getters return values from this sample
+ * until the next sample is complete. With oversampling this
+ * makes all conversions of a block at once.
+ */
+const Reading &NTCsensor::sample()
+{
+    startSampling();
+    _startWait();
+    while (! update())
+    {
+        if (_isWaitOver()) break;
+    }
+    return _reading;
+}
+
+bool NTCsensor::isTimedOut()
+{
+    return _isTimedOut;
+}
+
+void NTCsensor::_startWait()
+{
+    _isTimedOut = false;
+    _msWait     = millis();
+    _msPolled   = _msWait;
+    _polls      = 0;
+}
+
+/**
+ * The poll count catches a clock which doesn't run, e.g. the
+ * virtual time of a replay on the host
+ */
+bool NTCsensor::_isWaitOver()
+{
+    uint32_t msNow = millis();
+
+    if (msNow != _msPolled)
+    {
+        _msPolled = msNow;
+        _polls    = 0;
+    }
+    _isTimedOut = msNow - _msWait >= NTC_SAMPLE_TIMEOUT || ++_polls >= NTC_SAMPLE_POLLS;
+    return _isTimedOut;
+}
+
+const Reading &NTCsensor::getReading()
+{
+    return _reading;
 }
 
+#ifdef NTC_FIXED_POINT
 double NTCsensor::getCelsius()
 {
-    _readSensor();
-    return _tCelsius;
+    return _reading.cCelsius / 100.0;
 }
 
 double NTCsensor::getKelvin()
 {
-    _readSensor();
-    return _tKelvin;
+    return getCelsius() - _Tabs;
 }
 
 double NTCsensor::getFahrenheit()
 {
-    _readSensor();
-    return _tFahrenheit;
+    return getCelsius() * 9.0 / 5.0 + 32.0;
 }
 
 double NTCsensor::getRt()
 {
-    _readSensor();
-    return _Rt;
+    return _rtOf(getVin());
+}
+#else
+double NTCsensor::getCelsius()
+{
+    return _reading.celsius;
+}
+
+double NTCsensor::getKelvin()
+{
+    return _reading.kelvin;
 }
 
+double NTCsensor::getFahrenheit()
+{
+    return _reading.fahrenheit;
+}
+
+double NTCsensor::getRt()
+{
+    if (_lut.table != nullptr) return _rtOf(getVin());
+    return _reading.Rt;
+}
+#endif
+
 double NTCsensor::getRoo()
 {
     return _Roo;
 }
 
+double NTCsensor::getRtAt(double aval)
+{
+    return _rtOf(_vinOf(aval));
+}
+
+ParamsNTC &NTCsensor::getParamsNTC()
+{
+    return _ntc;
+}
+
+ParamsADC &NTCsensor::getParamsADC()
+{
+    return _adc;
+}
+
+uint16_t NTCsensor::getSamples()
+{
+    return _ovsSamples;
+}
+
+uint8_t NTCsensor::getExtraBits()
+{
+    return _ovsBits;
+}
+
 double NTCsensor::getAnalogValue()
 {
-    _readSensor();
-    return _analogValue;
+    return _reading.raw;
+}
+
+double NTCsensor::getFactorK()
+{
+    _rtOf(getVin());
+    return _k;
 }
 
 double NTCsensor::getFactorV()
 {
-    _readSensor();
     return _v;
 }
 
 double NTCsensor::getVin()
 {
-    _readSensor();
-    return _vin;
+#ifndef NTC_FIXED_POINT
+    if (_lut.table == nullptr) return _reading.vin;
+#endif
+#ifdef ESP32
+    return _vinOf(_rawToAval(_curveRaw(_reading.raw)));
+#else
+    return _vinOf(_rawToAval(_reading.raw));
+#endif
+}
+
+/**
+ * Fill table with the temperatures in centi-°C at the analog values 
+ * i << shift and switch to table mode. shift is chosen so that the 
+ * table covers the range 0 .. Amax. Returns the largest deviation 
+ * in °C from the model in the range NTC_LUT_TMIN .. NTC_LUT_TMAX.
+ * 
+ * table       buffer of size entries, e.g. 65 entries for Amax = 1023
+ */
+double NTCsensor::buildLookupTable(int16_t *table, uint16_t size)
+{
+    uint8_t shift = 0;
+
+    if (size < 2) return NAN;
+    _lut = {};                                                   // reconfigure() must not rebuild it
+#ifdef NTC_SUPPLY
+    double mvSupply = _mvSupply;                                 // the table is for the nominal supply
+    _mvSupply = 0;
+    reconfigure();
+#endif
+    while (((uint32_t)(size - 1) << shift) < _adc.Amax) shift++;
+    for (uint16_t i = 0; i < size; i++)
+    {
+#ifdef NTC_FIXED_POINT
+        if (! _isSH) 
+        {
+            table[i] = _fxCenti((uint32_t)i << shift, 0);
+            continue;
+        }
+#endif
+        table[i] = _centiOf(_rtOf(_vinOf((double)((uint32_t)i << shift))));
+    }
+    useLookupTable({ table, size, shift, false });
+    _lutBuffer = table;
+    double error = getLookupTableError();
+#ifdef NTC_SUPPLY
+    _mvSupply = mvSupply;
+    reconfigure();
+#endif
+    return error;
+}
+
+/**
+ * Use a table which was precalculated, e.g. a PROGMEM table 
+ * generated with tools/ntc_lut.py for the parameters in use
+ */
+void NTCsensor::useLookupTable(const LutNTC &lut)
+{
+    _lut       = lut;
+    _lutBuffer = nullptr;
+    _lutParams = _paramsHash();
+}
+
+void NTCsensor::disableLookupTable()
+{
+    _lut       = {};
+    _lutBuffer = nullptr;
+}
+
+bool NTCsensor::isSteinhartHart()
+{
+    return _isSH;
+}
+
+/**
+ * Calculate the Steinhart-Hart coefficients from 3 points with 
+ * different temperatures. Returns false if the points don't 
+ * determine the model.
+ */
+bool NTCsensor::fitSteinhartHart(ParamsSH &sh, const double (&celsius)[3], const double (&rt)[3])
+{
+    double L[3], Y[3];
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (! (rt[i] > 0.0) || ! (celsius[i] > -273.15)) return false;
+        L[i] = log(rt[i]);
+        Y[i] = 1.0 / (celsius[i] + 273.15);
+    }
+    if (L[0] == L[1] || L[0] == L[2] || L[1] == L[2] || L[0] + L[1] + L[2] == 0.0) return false;
+
+    double g2 = (Y[1] - Y[0]) / (L[1] - L[0]);
+    double g3 = (Y[2] - Y[0]) / (L[2] - L[0]);
+    sh.C = (g3 - g2) / (L[2] - L[1]) / (L[0] + L[1] + L[2]);
+    sh.B = g2 - sh.C * (L[0] * L[0] + L[0] * L[1] + L[1] * L[1]);
+    sh.A = Y[0] - (sh.B + sh.C * L[0] * L[0]) * L[0];
+    return true;
+}
+
+const LutNTC &NTCsensor::getLookupTable()
+{
+    return _lut;
+}
+
+#ifdef NTC_SUPPLY
+#ifndef NTC_BANDGAP_MUX
+  #define NTC_BANDGAP_MUX 0x0E  // ADMUX channel of the bandgap, ATmega328P
+#endif
+#ifndef NTC_BANDGAP_US
+  #define NTC_BANDGAP_US  1000  // settling time after the bandgap has been selected
+#endif
+
+#ifdef __AVR__
+void NTCsensor::useSupplyCompensation(uint16_t samples, bool ntcOnAVcc)
+{
+    if (samples == 0) return disableSupplyCompensation();
+    _isNtcOnAVcc   = ntcOnAVcc;
+    _supplyEvery   = samples;
+    _supplySamples = samples;                                    // measure before the next sample
+    _isBandgap     = false;
+}
+#endif
+
+#ifdef ESP32
+/**
+ * pinSupply measures Vcc / divider, the pin is set to 11 dB
+ */
+void NTCsensor::useSupplyCompensation(uint16_t samples, uint8_t pinSupply, double divider)
+{
+    if (samples == 0) return disableSupplyCompensation();
+    _supplyEvery   = samples;
+    _supplySamples = samples;
+    _pinSupply     = pinSupply;
+    _supplyDivider = divider;
+    _isAdcReady    = false;                                      // sets the attenuation of pinSupply
+}
+#endif
+
+void NTCsensor::disableSupplyCompensation()
+{
+    _supplyEvery = 0;
+    _mvSupply    = 0;
+    reconfigure();
+}
+
+double NTCsensor::getSupply()
+{
+    return _mvSupply;
+}
+
+/**
+ * AVR: the first call selects the bandgap, the first call after it has 
+ * settled converts it. Vbg = Aval * AVcc / Amax, so AVcc = Vbg * Amax / Aval.
+ * ESP32: one calibrated conversion of pinSupply.
+ */
+void NTCsensor::_measureSupply()
+{
+  #ifdef __AVR__
+    if (! _isBandgap)
+    {
+        ADMUX      = (1 << REFS0) | NTC_BANDGAP_MUX;              // AVcc as reference, analogRead() sets it back
+        _usBandgap = micros();
+        _isBandgap = true;
+        return;
+    }
+    if (micros() - _usBandgap < NTC_BANDGAP_US) return;
+    ADCSRA |= (1 << ADSC);
+    while (ADCSRA & (1 << ADSC)) {}
+    uint16_t aval = ADC;
+    _isBandgap = false;
+    if (aval > 0) _mvSupply = NTC_BANDGAP_MV * _adc.Amax / aval;
+  #endif
+  #ifdef ESP32
+    _mvSupply = analogReadMilliVolts(_pinSupply) * _supplyDivider;
+  #endif
+    _supplySamples = 0;
+    _applySupply();
+  #ifdef NTC_FIXED_POINT
+    _initFixedPoint();
+  #endif
+}
+
+/**
+ * AVR: AVcc is the reference, Vcc of the divider follows if the 
+ * divider is on AVcc. ESP32: the reference is internal, only Vcc changes.
+ */
+void NTCsensor::_applySupply()
+{
+    _lutScale = 0x8000;
+    if (_mvSupply <= 0) return;
+  #ifdef __AVR__
+    _v = (_mvSupply - _vOff) / (double)_adc.Amax;
+    if (_isNtcOnAVcc) _vcc = _mvSupply * _adc.Vcc / _adc.Vref;
+    double vNominal = (_adc.Vref - _adc.Voff) / (double)_adc.Amax;
+    _lutScale = (uint32_t)lround(32768.0 * (_v / vNominal) * (_adc.Vcc / _vcc));
+  #else
+    _vcc = _mvSupply;
+    _lutScale = (uint32_t)lround(32768.0 * _adc.Vcc / _vcc);
+  #endif
+}
+#endif
+
+#ifdef ESP32
+/**
+ * Switch between the attenuations of ranges. The pin, Amax and Vcc 
+ * of ParamsADC are used for all ranges. Starts with the largest range.
+ */
+void NTCsensor::useAutoRange(ParamsADC *const *ranges, uint8_t count)
+{
+    _ranges     = ranges;
+    _rangeCount = count;
+    if (count == 0) 
+    {
+        disableAutoRange();
+        return;
+    }
+    _range = _rangeNext = count - 1;
+    _applyRange(*_ranges[_range]);
+    startSampling();
+}
+
+void NTCsensor::disableAutoRange()
+{
+    _rangeCount = 0;
+    _range = _rangeNext = 0;
+    reconfigure();
+}
+
+uint8_t NTCsensor::getRange()
+{
+    return _range;
+}
+
+uint32_t NTCsensor::getRangeSwitches()
+{
+    return _rangeSwitches;
+}
+
+ParamsADC *const *NTCsensor::getRanges()
+{
+    return _rangeCount > 0 ? _ranges : nullptr;
+}
+
+uint8_t NTCsensor::getRangeCount()
+{
+    return _rangeCount;
+}
+
+/**
+ * The curve has to live as long as the sensor uses it
+ */
+void NTCsensor::setAdcCurve(adc_attenuation_t att, const AdcCurve *curve)
+{
+    if (att < NTC_ADC_ATTENUATIONS) _curves[att] = curve;
+}
+
+const AdcCurve *NTCsensor::getAdcCurve()
+{
+    return _curve;
+}
+
+void NTCsensor::_applyRange(const ParamsADC &range)
+{
+    analogSetPinAttenuation(_adc.pin, range.att);
+    _v    = (range.Vref - range.Voff) / (double)_adc.Amax;
+    _vOff = range.Voff;
+    _applyCurve(range.att);
+    #ifdef NTC_FIXED_POINT
+      _initFixedPoint();
+    #endif
+}
+
+/**
+ * The knots as analog values of the linear model of _v and _vOff,
+ * which then gives the voltage of the curve
+ */
+void NTCsensor::_applyCurve(adc_attenuation_t att)
+{
+    _curve = att < NTC_ADC_ATTENUATIONS ? _curves[att] : nullptr;
+    if (_curve == nullptr) return;
+    for (uint8_t i = 0; i <= NTC_ADC_KNOTS; i++)
+    {
+        _curveQ8[i] = (int32_t)lround((_curve->mv[i] - _vOff) / _v * 256.0);
+    }
+}
+
+/**
+ * Piecewise linear between the knots at i * Amax / NTC_ADC_KNOTS,
+ * raw scaled by 2^extraBits
+ */
+uint16_t NTCsensor::_curveRaw(uint16_t raw)
+{
+    if (_curve == nullptr) return raw;
+
+    uint32_t full = (uint32_t)_adc.Amax << _ovsBits;
+    uint64_t pos  = (uint64_t)(raw < full ? raw : full) * NTC_ADC_KNOTS;
+    uint8_t  i    = pos / full;
+    if (i >= NTC_ADC_KNOTS) i = NTC_ADC_KNOTS - 1;
+    int64_t  frac = (int64_t)(pos - (uint64_t)i * full);
+    int64_t  q8   = _curveQ8[i] + (int64_t)(_curveQ8[i + 1] - _curveQ8[i]) * frac / (int64_t)full;
+    int64_t  r    = ((q8 << _ovsBits) + 128) >> 8;
+    return r < 0 ? 0 : r > 0xFFFF ? 0xFFFF : (uint16_t)r;
+}
+
+/**
+ * Only the built-in ADC is switched, a source or the conversions of 
+ * add() may come from other pins, a table holds the scale of one range
+ */
+bool NTCsensor::_isRanging()
+{
+    return _rangeCount > 0 && _source.read == nullptr && _lut.table == nullptr;
+}
+
+void NTCsensor::_beginSample()
+{
+    if (_rangeNext != _range && _ovsCount == 0)                  // a new sample begins
+    {
+        _range = _rangeNext;
+        _applyRange(*_ranges[_range]);
+        _rangeSwitches++;
+    }
+}
+
+/**
+ * Choose the range for the next sample with hysteresis: up above 95 % 
+ * of the full scale, down below 85 % of the full scale of the smaller range
+ */
+void NTCsensor::_autoRange(uint16_t raw)
+{
+    uint32_t full = (uint32_t)_adc.Amax << _ovsBits;
+
+    if (raw >= full * 95 / 100)
+    {
+        if (_range + 1 < _rangeCount) _rangeNext = _range + 1;
+    }
+    else if (_range > 0 && _vinOf(_rawToAval(raw)) < 0.85 * _ranges[_range - 1]->Vref)
+    {
+        _rangeNext = _range - 1;
+    }
+}
+#endif
+
+/**
+ * Largest deviation in °C of the table from the model, 
+ * checked for every analog value with a temperature in the 
+ * range NTC_LUT_TMIN .. NTC_LUT_TMAX
+ */
+double NTCsensor::getLookupTableError()
+{
+    double maxError = 0.0;
+
+    if (_lut.table == nullptr) return NAN;
+    for (uint32_t a = 0; a <= _adc.Amax; a++)
+    {
+        double t = _celsiusOf(_rtOf(_vinOf((double)a)));
+        if (! (t >= NTC_LUT_TMIN && t <= NTC_LUT_TMAX)) continue;
+        double e = fabs(_lookup(_lutRaw(a << _ovsBits)) / 100.0 - t);
+        if (e > maxError) maxError = e;
+    }
+    return maxError;
 }
 
 /**
@@ -146,7 +1081,7 @@ double NTCsensor::getVin()
  */
 void NTCsensor::printParams()
 {
-    char buf[272];
+    char buf[304];
 
     snprintf(buf, sizeof(buf), R"(--- NTC Parameters ---
 beta        %d
@@ -162,14 +1097,16 @@ NTC to GND  %s
 Vcc        %5.0f mV
 Vref       %5.0f mV
 Voff       %5.0f mV
+Samples     %d
+Extra bits  %d
 )",
 _ntc.beta, _ntc.Ro, _ntc.Rs, _Roo, _To, _Tabs, 
-_adc.pin, _adc.Amax, _adc.ntcToGround ? "true" : "false", _adc.Vcc, _adc.Vref, _adc.Voff );
+_adc.pin, _adc.Amax, _adc.ntcToGround ? "true" : "false", _adc.Vcc, _adc.Vref, _adc.Voff, _ovsSamples, _ovsBits );
 Serial.println(buf);
 }
 
 /**
- * Print sensor readings to monitor
+ * Print the values of the last sample to monitor
  * 
  * analogValue  reading from analog pin
  * Rt           calculated resistanc of NTC at temperature T
@@ -181,7 +1118,6 @@ void NTCsensor::printValues()
 {
     char buf[184];
 
-    _readSensor();
     snprintf(buf, sizeof(buf), R"(--- Sensor Readings ---
 Analog Value %d
 v        %7.5f
@@ -191,6 +1127,6 @@ Rt         %5.0f
 Tc         %5.1f °C
 Tf         %5.1f °F
 Tk         %5.1f °K
-)", _analogValue, _v, _vin, _k, _Rt, _tCelsius, _tFahrenheit, _tKelvin);
+)", _reading.raw, _v, getVin(), getFactorK(), getRt(), getCelsius(), getFahrenheit(), getKelvin());
 Serial.println(buf);
 }
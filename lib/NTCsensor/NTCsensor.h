@@ -7,16 +7,238 @@
  * Constructor
  * arguments    &ntc       A reference to a struct holding the NTC parameters
  *              &adc       A reference to a struct holding the ADC parameters
+ * 
+ * Usage        sample() performs one conversion and returns a Reading with all the 
+ *              derived values. The getters return the values of the last sample 
+ *              and never touch the ADC.
+ * 
+ *              If ParamsADC.ovs points to a ParamsOVS struct, a sample is made of 
+ *              several conversions. startSampling() begins a new block and update() 
+ *              makes one conversion per call, so the work is spread across loop().
+ *              update() returns true when the block is complete. sample() runs 
+ *              the whole block at once. If the conversions stop, e.g. after a failed
+ *              begin() of an ADC or at the end of a replay, sample() gives up after
+ *              NTC_SAMPLE_TIMEOUT ms and returns the last sample, isTimedOut() is true.
+ * 
+ *              buildLookupTable() or useLookupTable() switch to table mode. The 
+ *              temperature is then interpolated from a table of centi-°C instead of 
+ *              being calculated with log(). Vin and Rt are only calculated when 
+ *              their getters are called. A table belongs to the parameters in use when 
+ *              it is set. If reconfigure() finds other parameters, e.g. restored by 
+ *              NTCconfig or solved by NTCcalibration, a table of buildLookupTable() is 
+ *              built again and any other table is dropped.
+ * 
+ *              If ParamsNTC.sh points to Steinhart-Hart coefficients, they are used 
+ *              instead of beta. The model is evaluated with a fast ln() approximation.
+ * 
+ *              On the ESP32 useAutoRange() switches between several ParamsADC with 
+ *              different attenuations. After a sample close to the full scale the 
+ *              next larger range is chosen, after a sample which fits well into the 
+ *              next smaller range that one. The new range applies from the first 
+ *              conversion of the next sample, so the values of the last sample stay 
+ *              consistent. Only the built-in ADC of update() / sample() is switched, 
+ *              with a source, a lookup table or conversions of add() the range stays.
+ * 
+ *              The ADC of the ESP32 is not linear. setAdcCurve() sets the characteristic 
+ *              of one attenuation, e.g. measured by NTCcalibration::characterizeAdc(). 
+ *              The analog values are then corrected piecewise linear before they are 
+ *              converted, reconfigure() and each switch of the range install the curve 
+ *              of the attenuation in use.
+ * 
+ *              setSource() replaces analogRead() by a source of conversions which 
+ *              were made in the background, e.g. by DMA. update() then consumes all 
+ *              available conversions without waiting.
+ * 
+ *              update(adc) and sample(adc) read from an ADC policy instead, a class 
+ *              with read() and begin(), see AdcBuiltin. The calls are resolved at 
+ *              compile time, so an external ADC or a replay costs no indirect call 
+ *              per conversion. sourceOf(adc) wraps a policy into an AdcSource where 
+ *              the type has to be erased, useSource(adc) calls begin() of the policy 
+ *              and sets the source. The built-in ADC is only set up with the first 
+ *              call of update() or sample(), never by the constructor.
+ * 
+ *              useSupplyCompensation() measures the supply every few samples and 
+ *              corrects the conversion with it. On AVR the internal bandgap is converted 
+ *              against AVcc, which gives AVcc, the reference of the ADC. An NTC divider on 
+ *              AVcc is ratiometric and follows, a divider on a separate supply 
+ *              (ntcOnAVcc = false) is corrected. On the ESP32 the reference is 
+ *              internal and the attenuated Vcc at a pin is measured with the calibrated 
+ *              analogReadMilliVolts(), which corrects Vcc. A measurement takes the place of 
+ *              one conversion of update(), on AVR the bandgap settles during another call. 
+ *              Only for the built-in ADC.
+ * 
+ * Build flags  NTC_STATS        count conversions and samples and measure the time of the 
+ *                               conversion to temperature, see getStats()
+ *              NTC_FIXED_POINT  integer conversion, Reading only holds raw and cCelsius
+ *                               and the getters calculate the other values on demand. 
+ *                               Default on AVR.
+ *              NTC_FLOAT_POINT  floating point conversion also on AVR
  */
 #ifndef _NTCSENSOR_H_
 #define _NTCSENSOR_H_
 #include <Arduino.h> 
 
-using ParamsNTC = struct paramsNtc { uint16_t Rs; uint16_t Ro; uint16_t beta; };
+#if defined(__AVR__) && ! defined(NTC_FLOAT_POINT) && ! defined(NTC_FIXED_POINT)
+  #define NTC_FIXED_POINT
+#endif
+
+#if defined(__AVR__) || defined(ESP32)
+  #define NTC_SUPPLY            // supply compensation available
+#endif
+
+#ifndef NTC_BANDGAP_MV
+  #define NTC_BANDGAP_MV 1100.0 // bandgap of the AVR, 1.0 .. 1.2 V, calibrate for the best accuracy
+#endif
+
+#ifndef NTC_SAMPLE_TIMEOUT
+  #define NTC_SAMPLE_TIMEOUT 1000    // ms sample() waits for a complete block
+#endif
+#ifndef NTC_SAMPLE_POLLS
+  #define NTC_SAMPLE_POLLS   1000000 // calls of update() in the same millisecond, virtual time stands still
+#endif
+
+#ifndef NTC_MEDIAN_MAX
+  #define NTC_MEDIAN_MAX 15     // max. number of conversions buffered for the median
+#endif
+
+/**
+ * Oversampling
+ * samples     number of conversions per sample
+ * extraBits   0..6, oversample 4^extraBits conversions and shift to gain extra bits
+ *             Reading.raw is then scaled by 2^extraBits
+ * reject      OVS_MEAN     mean of all conversions
+ *             OVS_TRIMMED  mean without the smallest and the largest conversion
+ *             OVS_MEDIAN   median, at most NTC_MEDIAN_MAX conversions
+ */
+enum OvsReject { OVS_MEAN, OVS_TRIMMED, OVS_MEDIAN };
+using ParamsOVS = struct paramsOvs { uint16_t samples; uint8_t extraBits; OvsReject reject; };
+
+/**
+ * Steinhart-Hart model 1/T = A + B * ln(Rt) + C * ln(Rt)^3, T in K, Rt in Ohm
+ * If ParamsNTC.sh points to the coefficients, they replace the Beta model.
+ * fitSteinhartHart() calculates them from 3 measured points.
+ */
+using ParamsSH  = struct paramsSh { double A; double B; double C; };
+
+using ParamsNTC = struct paramsNtc { uint16_t Rs; uint16_t Ro; uint16_t beta; ParamsSH *sh; };
+#ifdef ESP32
+  using ParamsADC = struct parmsAdc{ uint8_t pin; bool ntcToGround; uint16_t Amax; adc_attenuation_t att; double Vcc; double Vref; double Voff; ParamsOVS *ovs; };
+#else
+    using ParamsADC = struct paramsAdc { uint8_t pin; bool ntcToGround; uint16_t Amax; double Vcc; double Vref; double Voff; ParamsOVS *ovs; };
+#endif
+
 #ifdef ESP32
-  using ParamsADC = struct parmsAdc{ uint8_t pin; bool ntcToGround; uint16_t Amax; adc_attenuation_t att; double Vcc; double Vref; double Voff; };
+  #ifndef NTC_ADC_KNOTS
+    #define NTC_ADC_KNOTS 16    // segments of the characteristic of an attenuation
+  #endif
+  #define NTC_ADC_ATTENUATIONS 4
+
+/**
+ * Characteristic of the ESP32 ADC at one attenuation
+ * mv          input in mV at the analog values i * Amax / NTC_ADC_KNOTS, 
+ *             mv[0] and mv[NTC_ADC_KNOTS] should be Voff and Vref
+ */
+  using AdcCurve = struct adcCurve { uint16_t mv[NTC_ADC_KNOTS + 1]; };
+#endif
+
+// One conversion and all the values derived from it, cCelsius in 1/100 °C
+#ifdef NTC_FIXED_POINT
+  using Reading = struct reading { uint32_t ms; uint16_t raw; int16_t cCelsius; };
 #else
-    using ParamsADC = struct paramsAdc { uint8_t pin; bool ntcToGround; uint16_t Amax; double Vcc; double Vref; double Voff; };
+  using Reading = struct reading { uint32_t ms; uint16_t raw; int16_t cCelsius; double vin; double Rt; double kelvin; double celsius; double fahrenheit; };
+#endif
+
+/**
+ * Source of conversions
+ * read        returns true and the next analog value if one is available, 
+ *             must not block
+ * ctx         passed to read, e.g. the object behind the source
+ * isBuffered  true if read may deliver several conversions at once, update() 
+ *             then consumes all of them, else one per call
+ */
+using AdcSource = struct adcSource { bool (*read)(void *ctx, uint16_t &aval); void *ctx; bool isBuffered; };
+
+/**
+ * ADC policy for update(adc), a class with
+ * begin()             sets up the ADC, called by the user or by the owner of the policy
+ * read(aval)          returns true and the next analog value, false if none is available yet
+ * isBuffered          true: update() consumes all available conversions, 
+ *                     false: update() makes one conversion per call
+ * AdcBuiltin is the ADC of the board with analogRead(), which is the default of update().
+ */
+class AdcBuiltin
+{
+  public:
+    AdcBuiltin(const ParamsADC &adc) : _adc(adc) {}
+
+    static const bool isBuffered = false;
+
+    void begin()
+    {
+        pinMode(_adc.pin, INPUT);
+      #ifdef ESP32
+        analogSetAttenuation(_adc.att);
+      #endif
+    }
+
+    bool read(uint16_t &aval)
+    {
+        aval = analogRead(_adc.pin);
+        return true;
+    }
+
+  private:
+    const ParamsADC &_adc;
+};
+
+/**
+ * Policy reading from an AdcSource, used by update() after setSource()
+ */
+template <bool buffered>
+class AdcFromSource
+{
+  public:
+    AdcFromSource(const AdcSource &source) : _source(source) {}
+
+    static const bool isBuffered = buffered;
+
+    void begin() {}
+    bool read(uint16_t &aval) { return _source.read(_source.ctx, aval); }
+
+  private:
+    const AdcSource &_source;
+};
+
+/**
+ * Erase the type of an ADC policy, e.g. for setSource() or a library 
+ * which takes an AdcSource. adc has to live as long as the source.
+ */
+template <class Adc>
+AdcSource sourceOf(Adc &adc)
+{
+    return { [](void *ctx, uint16_t &aval) { return static_cast<Adc *>(ctx)->read(aval); }, &adc, Adc::isBuffered };
+}
+
+/**
+ * Instrumentation with NTC_STATS, all zero without
+ * conversions   analog values added, samples  completed samples
+ * usConvert     µs spent converting samples to temperatures, usConvertMax  longest
+ */
+using SensorStats = struct sensorStats { uint32_t conversions; uint32_t samples; uint32_t usConvert; uint32_t usConvertMax; };
+
+/**
+ * Lookup table
+ * table       centi-°C at the analog values i << shift, i = 0 .. size-1
+ *             values beyond the range of int16_t are clipped to INT16_MIN / INT16_MAX
+ * inProgmem   true if the table is stored with PROGMEM (generated by tools/ntc_lut.py)
+ */
+using LutNTC = struct lutNtc { const int16_t *table; uint16_t size; uint8_t shift; bool inProgmem; };
+
+#ifndef NTC_LUT_TMIN
+  #define NTC_LUT_TMIN  -40.0   // range in °C in which buildLookupTable() reports the error
+#endif
+#ifndef NTC_LUT_TMAX
+  #define NTC_LUT_TMAX  125.0
 #endif
 
 class NTCsensor
@@ -24,24 +246,67 @@ class NTCsensor
   public:
     NTCsensor(ParamsNTC &ntc, ParamsADC &adc)  : _ntc(ntc), _adc(adc)
       {
-        pinMode(_adc.pin, INPUT);
-        #ifdef ESP32
-          analogSetAttenuation(_adc.att);
-        #endif
-        _Roo = _ntc.Ro * exp(-(double)_ntc.beta / (_To - _Tabs)); // calculate the resistance of the NTC for T --> oo
+        reconfigure();
       }
 
+    void  reconfigure();          // recalculate the constants after the parameters have changed
+
+    const Reading &sample();      // read the sensor once and return the derived values
+    const Reading &getReading();  // returns the last sample without reading the sensor
+    bool  isTimedOut();           // true if the last sample() returned the old sample
+    void  startSampling();        // begin a new block of conversions
+    bool  update();               // one conversion, true when a new sample is ready
+    template <class Adc> bool update(Adc &adc);            // the same with an ADC policy
+    template <class Adc> const Reading &sample(Adc &adc);
+    bool  add(uint16_t aval);     // add a conversion made elsewhere, true when a new sample is ready
+    bool  isOversampling();       // true if a sample needs more than one conversion
+    void  setSource(const AdcSource &source);  // read conversions from source instead of analogRead()
+    template <class Adc> void useSource(Adc &adc);         // begin() of the policy and setSource(sourceOf(adc))
+    bool  isSteinhartHart();      // true if the Steinhart-Hart model is used
+    static bool fitSteinhartHart(ParamsSH &sh, const double (&celsius)[3], const double (&rt)[3]);
+    double buildLookupTable(int16_t *table, uint16_t size);  // returns the max. error in °C
+    void  useLookupTable(const LutNTC &lut);                 // use a precalculated table
+    void  disableLookupTable();
+    const LutNTC &getLookupTable();
+  #ifdef ESP32
+    void  useAutoRange(ParamsADC *const *ranges, uint8_t count);  // ranges with increasing Vref, same pin
+    void  disableAutoRange();     // back to the attenuation of ParamsADC
+    uint8_t  getRange();          // index of the range in use
+    uint32_t getRangeSwitches();
+    ParamsADC *const *getRanges();  // ranges of useAutoRange(), nullptr if none
+    uint8_t  getRangeCount();
+    void  setAdcCurve(adc_attenuation_t att, const AdcCurve *curve);  // nullptr for linear, applied by reconfigure()
+    const AdcCurve *getAdcCurve();   // curve of the attenuation in use, nullptr if linear
+  #endif
+  #ifdef __AVR__
+    void  useSupplyCompensation(uint16_t samples, bool ntcOnAVcc = true);  // measure AVcc with the bandgap every samples samples
+  #endif
+  #ifdef ESP32
+    void  useSupplyCompensation(uint16_t samples, uint8_t pinSupply, double divider = 2.0);  // Vcc / divider at pinSupply
+  #endif
+  #ifdef NTC_SUPPLY
+    void  disableSupplyCompensation();
+    double getSupply();           // last measured supply in mV, 0 if not measured
+  #endif
+    double getLookupTableError();  // max. deviation in °C from the model
     double getCelsius();
     double getKelvin();
     double getFahrenheit();
-    double getAnalogValue();    // returns the actual analog value
-    double getRt();             // returns resistance of NTC at actual temperature
+    double getAnalogValue();    // returns the analog value of the last sample
+    double getRt();             // returns resistance of NTC at the last sample
     double getRoo();            // returns R(T-->oo)
+    double getRtAt(double aval);  // resistance of the NTC at the analog value aval (not scaled) 
+    ParamsNTC &getParamsNTC();
+    ParamsADC &getParamsADC();
+    uint16_t getSamples();      // conversions per sample
+    uint8_t  getExtraBits();    // extra bits by oversampling
     double getFactorK();        // returns k (Rt = Rs * k) 
     double getFactorV();        // returns v (Vref - Voff)/Amax
     double getVin();            // returns the applied input voltage
+    SensorStats getStats();     // counters of NTC_STATS, all zero without
+    void  resetStats();
     void  printParams();        // print the sensors (NTC) parameters
-    void  printValues();        // print the measured values
+    void  printValues();        // print the values of the last sample
 
   private:
     ParamsNTC &_ntc;
@@ -50,17 +315,141 @@ class NTCsensor
     double       _Roo;            // resistance for T --> oo
     double       _k;              // k = Vin / (Vcc - Voff)
     double       _v;              // v = (Vref - Voff) / analogMax
+    double       _vOff;           // Voff of the range in use
+    double       _vcc;            // Vcc of the divider, corrected by the supply compensation
     const double _To   = 25.0;    // nominal temperature
     const double _Tabs = -273.15; // absolute temperature
+    bool         _isSH = false;   // Steinhart-Hart instead of Beta model
+    double       _shA;            // coefficients copied from ParamsNTC.sh
+    double       _shB;
+    double       _shC;
+
+    Reading  _reading = {}; // values of the last sample
+
+    uint16_t _ovsSamples = 1;   // conversions per sample
+    uint8_t  _ovsBits    = 0;   // extra bits by oversampling
+    uint16_t _ovsCount;         // conversions in the current block
+    uint32_t _ovsSum;
+    uint16_t _ovsMin;
+    uint16_t _ovsMax;
+    uint16_t _ovsSorted[NTC_MEDIAN_MAX];  // conversions sorted for the median
+    double   _rawStep;          // ADC steps per step of Reading.raw
+    LutNTC   _lut = {};         // table mode if _lut.table != nullptr
+    int16_t *_lutBuffer = nullptr;  // table of buildLookupTable(), rebuilt by reconfigure()
+    uint32_t _lutParams = 0;    // _paramsHash() of the parameters of the table
+    AdcSource _source = {};     // analogRead() if _source.read == nullptr
+  #ifdef NTC_STATS
+    SensorStats _stats = {};
+  #endif
+    bool     _isAdcReady = false;  // built-in ADC set up
+    bool     _isTimedOut = false;  // the last sample() got no complete block
+    uint32_t _msWait;           // sample() waits since
+    uint32_t _msPolled;         // millis() of the last poll
+    uint32_t _polls;            // polls in the same millisecond
+
+    void  _beginAdc();          // set up the built-in ADC
+    uint32_t _paramsHash();     // fingerprint of the parameters a table depends on
+    void  _startWait();
+    bool  _isWaitOver();        // true after NTC_SAMPLE_TIMEOUT or NTC_SAMPLE_POLLS
+    void  _initOversampling();
+    void  _accumulate(uint16_t aval);
+    uint16_t _blockValue();     // analog value of the completed block
+    void  _convert(uint16_t raw);  // update the calculated values from an analog value
+    double _vinOf(double aval);    // input voltage at the analog value aval
+    double _rtOf(double vin);      // resistance of the NTC at the input voltage vin
+    double  _celsiusOf(double rt); // temperature in °C at the resistance rt, Beta or Steinhart-Hart
+    int16_t _centiOf(double rt);   // temperature in centi-°C at the resistance rt, clipped
+    int16_t _toCenti(double celsius);
+    int16_t _lookup(uint16_t raw); // temperature in centi-°C interpolated from the table
+    uint16_t _lutRaw(uint16_t raw);  // raw corrected for the table
+    double  _rawToAval(uint16_t raw);  // analog value of Reading.raw
+
+  #ifdef NTC_SUPPLY
+    uint16_t _supplyEvery   = 0;  // samples between two measurements of the supply, 0 for none
+    uint16_t _supplySamples = 0;  // samples since the last measurement
+    double   _mvSupply      = 0;  // last measured supply, 0 if not measured yet
+    uint32_t _lutScale      = 0x8000;  // Q15, raw of the table at nominal supply / raw
+   #ifdef __AVR__
+    bool     _isBandgap     = false;   // bandgap selected, settling
+    bool     _isNtcOnAVcc   = true;    // Vcc of the divider follows AVcc
+    uint32_t _usBandgap;
+   #endif
+   #ifdef ESP32
+    uint8_t  _pinSupply;
+    double   _supplyDivider;
+   #endif
+
+    void  _measureSupply();     // one step of the measurement
+    void  _applySupply();       // correct the constants with _mvSupply
+  #endif
+
+  #ifdef ESP32
+    ParamsADC *const *_ranges = nullptr;  // auto-ranging if _rangeCount > 0
+    uint8_t  _rangeCount = 0;
+    uint8_t  _range      = 0;     // range in use
+    uint8_t  _rangeNext  = 0;     // range for the next sample
+    uint32_t _rangeSwitches = 0;
+    const AdcCurve *_curves[NTC_ADC_ATTENUATIONS] = {};
+    const AdcCurve *_curve = nullptr;  // curve in use
+    int32_t  _curveQ8[NTC_ADC_KNOTS + 1];  // corrected analog values at the knots, Q8
+
+    void  _applyRange(const ParamsADC &range);
+    void  _applyCurve(adc_attenuation_t att);  // after _v and _vOff
+    uint16_t _curveRaw(uint16_t raw);  // raw corrected with the curve
+    bool  _isRanging();         // auto-ranging applies: built-in ADC, no table
+    void  _autoRange(uint16_t raw);
+    void  _beginSample();       // switch the range when a new sample begins
+  #endif
 
-    double   _vin;          // input voltage on ADC-pin
-    double   _Rt;           // calculated resistance at temperature T
-    double   _tKelvin;      // calculated temperature in °K
-    double   _tCelsius;     // calculated temperature in °C
-    double   _tFahrenheit;  // calculated temperature in °F
-    uint16_t _analogValue;  // measured analog value Aval
+  #ifdef NTC_FIXED_POINT
+    int32_t  _fxVoff;           // Voff in mV
+    int32_t  _fxSpan;           // Vref - Voff in mV
+    int32_t  _fxVcc;            // Vcc in mV
+    int32_t  _fxC2;             // log2(Rs / Ro) + BETA / (To * ln2), Q16
+    uint32_t _fxB;              // BETA / ln2, Q16
 
-    void  _readSensor();        // read the sensor and update the measured values
+    void    _initFixedPoint();
+    int16_t _fxCenti(uint32_t aval, uint8_t bits);  // integer Beta formula, aval scaled by 2^bits
+  #endif
 };
 
+/**
+ * adc has to live as long as it is the source
+ */
+template <class Adc>
+void NTCsensor::useSource(Adc &adc)
+{
+    adc.begin();
+    setSource(sourceOf(adc));
+}
+
+/**
+ * Read the ADC policy until the sample is complete or no more conversions 
+ * are available. An unbuffered ADC makes one conversion per call.
+ */
+template <class Adc>
+bool NTCsensor::update(Adc &adc)
+{
+    uint16_t aval;
+
+    if (! Adc::isBuffered) return adc.read(aval) && add(aval);
+    while (adc.read(aval))
+    {
+        if (add(aval)) return true;
+    }
+    return false;
+}
+
+template <class Adc>
+const Reading &NTCsensor::sample(Adc &adc)
+{
+    startSampling();
+    _startWait();
+    while (! update(adc))
+    {
+        if (_isWaitOver()) break;
+    }
+    return _reading;
+}
+
 #endif
@@ -0,0 +1,109 @@
+/**
+ * Header       NTCsensorArray.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration and implementation of the class template NTCsensorArray
+ *              which samples N thermistors of the same kind round-robin. 
+ * 
+ *              Each call of update() makes exactly one conversion on the current 
+ *              channel. When the sample of the channel is complete (after one or, 
+ *              with oversampling, several conversions) its result is stored and 
+ *              the next channel follows. So the cost of a loop() pass does not grow 
+ *              with the number of sensors.
+ * 
+ *              The results are kept as struct of arrays: analog value, temperature 
+ *              in centi-°C and time of the sample per channel.
+ * 
+ * Constructor
+ * arguments    &converter    an NTCsensor which holds the NTC and ADC parameters shared by
+ *                            all channels (oversampling, lookup table, fixed point); its 
+ *                            own pin is not used
+ *              pins          the analog input pins of the N channels, set to the attenuation
+ *                            of the converter on the ESP32
+ * 
+ * Remarks      Thermistors with different parameters need an array each. The auto-ranging
+ *              of NTCsensor only switches the converter's own pin, not the channels.
+ */
+#ifndef _NTCSENSORARRAY_H_
+#define _NTCSENSORARRAY_H_
+#include <Arduino.h>
+#include "NTCsensor.h"
+
+template <uint8_t N>
+class NTCsensorArray
+{
+    public:
+        NTCsensorArray(NTCsensor &converter, const uint8_t (&pins)[N]) : _converter(converter)
+        {
+            for (uint8_t i = 0; i < N; i++)
+            {
+                _pins[i] = pins[i];
+                pinMode(_pins[i], INPUT);
+              #ifdef ESP32
+                analogSetPinAttenuation(_pins[i], _converter.getParamsADC().att);
+              #endif
+            }
+            _converter.startSampling();
+        }
+
+        /**
+         * Make one conversion on the current channel. Returns true when 
+         * the sample of this channel is complete, getLastChannel() then 
+         * tells which one it was.
+         */
+        bool update()
+        {
+            if (! _converter.add(analogRead(_pins[_channel]))) return false;
+
+            _store(_channel);
+            if (++_channel >= N) 
+            {
+                _channel = 0;
+                _rounds++;
+            }
+            return true;
+        }
+
+        /**
+         * Make one conversion on the given channel, e.g. for a scheduler 
+         * which decides which channel is due. Returns true when the sample 
+         * is complete. Don't switch the channel before, and don't mix with 
+         * update() while a sample is in progress.
+         */
+        bool update(uint8_t channel)
+        {
+            if (! _converter.add(analogRead(_pins[channel]))) return false;
+
+            _store(channel);
+            return true;
+        }
+
+        uint8_t  size()                          { return N; }
+        uint8_t  getLastChannel()                { return _last; }
+        uint32_t getRounds()                     { return _rounds; }   // completed rounds over all channels
+        uint16_t getAnalogValue(uint8_t channel) { return _raw[channel]; }
+        int16_t  getCentiCelsius(uint8_t channel){ return _cCelsius[channel]; }
+        double   getCelsius(uint8_t channel)     { return _cCelsius[channel] / 100.0; }
+        uint32_t getTimestamp(uint8_t channel)   { return _ms[channel]; }  // millis() of the last sample
+        uint8_t  getPin(uint8_t channel)         { return _pins[channel]; }
+
+    private:
+        void _store(uint8_t channel)
+        {
+            const Reading &r = _converter.getReading();
+            _raw[channel]      = r.raw;
+            _cCelsius[channel] = r.cCelsius;
+            _ms[channel]       = r.ms;
+            _last = channel;
+        }
+
+        NTCsensor &_converter;
+        uint8_t  _channel = 0;          // channel being sampled
+        uint8_t  _last    = 0;          // channel of the last completed sample
+        uint32_t _rounds  = 0;
+        uint8_t  _pins[N];
+        uint16_t _raw[N]      = {};
+        int16_t  _cCelsius[N] = {};
+        uint32_t _ms[N]       = {};
+};
+#endif
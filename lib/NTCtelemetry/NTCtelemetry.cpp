@@ -0,0 +1,138 @@
+/**
+ * Class        NTCtelemetry.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class NTCtelemetry. A sample frame has 15 bytes, 0xA5, 
+ *              type, length, 11 bytes payload and CRC-8. At 115200 baud it is on the 
+ *              wire in 1.3 ms while the loop continues.
+ * 
+ * Board        Arduino uno, Wemos D1 R2, ESP32 DevKit V1
+ * 
+ **/
+
+#include "NTCtelemetry.h"
+
+static const uint8_t sampleLen = 11;
+static const uint8_t paramsLen = 27;
+
+/**
+ * CRC-8, polynomial x^8 + x^2 + x + 1
+ */
+static uint8_t crc8(uint8_t crc, uint8_t b)
+{
+    crc ^= b;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x80) ? (uint8_t)(crc << 1) ^ 0x07 : (uint8_t)(crc << 1);
+    return crc;
+}
+
+/**
+ * Answer requests from the host and transmit as many buffered 
+ * bytes as the serial port accepts without blocking
+ */
+void NTCtelemetry::loop()
+{
+    while (_port.available() > 0)
+    {
+        if (_port.read() == 'P') sendParams();
+    }
+
+    int room = _port.availableForWrite();
+    while (room-- > 0 && _tail != _head)
+    {
+        _port.write(_buf[_tail]);
+        _tail = (_tail + 1) & (NTC_TELEMETRY_BUF - 1);
+    }
+}
+
+bool NTCtelemetry::sendSample(const Reading &r)
+{
+    if (! _begin(TLM_SAMPLE, sampleLen)) return false;
+    _put16(_seq++);
+    _put32(r.ms);
+    _put16(r.raw);
+    _put16((uint16_t)r.cCelsius);
+    _put(_thermostat.isOutputOn() ? 0x01 : 0x00);
+    _end();
+    return true;
+}
+
+bool NTCtelemetry::sendParams()
+{
+    ParamsNTC &ntc = _ntcSensor.getParamsNTC();
+    ParamsADC &adc = _ntcSensor.getParamsADC();
+
+    if (! _begin(TLM_PARAMS, paramsLen)) return false;
+    _put16(ntc.Rs);
+    _put16(ntc.Ro);
+    _put16(ntc.beta);
+    _put(adc.pin);
+    _put(adc.ntcToGround ? 1 : 0);
+    _put16(adc.Amax);
+    _put16((uint16_t)(int16_t)adc.Vcc);
+    _put16((uint16_t)(int16_t)adc.Vref);
+    _put16((uint16_t)(int16_t)adc.Voff);
+    _put16(_ntcSensor.getSamples());
+    _put(_ntcSensor.getExtraBits());
+    _put16((uint16_t)_thermostat.getCentiLimitLow());
+    _put16((uint16_t)_thermostat.getCentiLimitHigh());
+    _put32(_thermostat.getRefreshInterval());
+    _end();
+    return true;
+}
+
+uint16_t NTCtelemetry::getDropped()
+{
+    return _dropped;
+}
+
+bool NTCtelemetry::isIdle()
+{
+    return _head == _tail;
+}
+
+uint8_t NTCtelemetry::_free()
+{
+    return (NTC_TELEMETRY_BUF - 1) - ((_head - _tail) & (NTC_TELEMETRY_BUF - 1));
+}
+
+/**
+ * Start a frame if sync, header, payload and crc fit into the buffer
+ */
+bool NTCtelemetry::_begin(uint8_t type, uint8_t len)
+{
+    if (_free() < len + 4)
+    {
+        _dropped++;
+        return false;
+    }
+    _put(_sync);
+    _crc = 0;
+    _put(type);
+    _put(len);
+    return true;
+}
+
+void NTCtelemetry::_put(uint8_t b)
+{
+    _buf[_head] = b;
+    _head = (_head + 1) & (NTC_TELEMETRY_BUF - 1);
+    _crc = crc8(_crc, b);
+}
+
+void NTCtelemetry::_put16(uint16_t w)
+{
+    _put(w & 0xFF);
+    _put(w >> 8);
+}
+
+void NTCtelemetry::_put32(uint32_t l)
+{
+    _put16(l & 0xFFFF);
+    _put16(l >> 16);
+}
+
+void NTCtelemetry::_end()
+{
+    uint8_t crc = _crc;
+    _put(crc);
+}
@@ -0,0 +1,73 @@
+/**
+ * Header       NTCtelemetry.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration of the class NTCtelemetry, a compact binary telemetry of the 
+ *              thermostat. Frames are encoded without printf and without allocation into 
+ *              a transmit ring buffer. loop() moves only as many bytes to the serial port 
+ *              as fit into its buffer, so sending never blocks. A frame which does not fit
+ *              into the ring buffer is dropped and counted.
+ * 
+ *              The parameters are only sent on request: the host sends the character 'P'.
+ *              tools/ntc_telemetry.py decodes the frames on the host.
+ * 
+ * Constructor
+ * arguments    &port         the serial port
+ *              &ntcSensor    the sensor whose parameters are reported
+ *              &thermostat   the thermostat whose limits and output are reported
+ * 
+ * Frame        0xA5  type  len  payload[len]  crc8         all values little endian
+ *              crc8 over type, len and payload, polynomial 0x07
+ * 
+ *  type 0x01   sample  seq u16, ms u32, raw u16, cCelsius i16, flags u8 (bit 0 output on)
+ *  type 0x02   params  Rs u16, Ro u16, beta u16, pin u8, ntcToGround u8, Amax u16,
+ *                      Vcc i16, Vref i16, Voff i16 (mV), samples u16, extraBits u8,
+ *                      limitLow i16, limitHigh i16 (centi-°C), msRefresh u32
+ */
+#ifndef _NTCTELEMETRY_H_
+#define _NTCTELEMETRY_H_
+#include <Arduino.h>
+#include "NTCsensor.h"
+#include "NTCthermostat.h"
+
+#ifndef NTC_TELEMETRY_BUF
+  #define NTC_TELEMETRY_BUF 64      // size of the transmit ring buffer, must be a power of 2
+#endif
+
+static_assert((NTC_TELEMETRY_BUF & (NTC_TELEMETRY_BUF - 1)) == 0 && NTC_TELEMETRY_BUF <= 256, 
+              "NTC_TELEMETRY_BUF must be a power of 2 up to 256");
+
+enum TelemetryType { TLM_SAMPLE = 0x01, TLM_PARAMS = 0x02 };
+
+class NTCtelemetry
+{
+    public:
+        NTCtelemetry(HardwareSerial &port, NTCsensor &ntcSensor, NTCthermostat &thermostat) :
+                     _port(port), _ntcSensor(ntcSensor), _thermostat(thermostat) {}
+
+        void     loop();                          // handle requests and transmit buffered bytes
+        bool     sendSample(const Reading &r);    // queue a sample frame, false if dropped
+        bool     sendParams();                    // queue a parameter frame, false if dropped
+        uint16_t getDropped();                    // frames dropped because the buffer was full
+        bool     isIdle();                        // true if all frames are passed to the port
+
+    private:
+        static const uint8_t _sync = 0xA5;
+        HardwareSerial &_port;
+        NTCsensor      &_ntcSensor;
+        NTCthermostat  &_thermostat;
+        uint8_t  _buf[NTC_TELEMETRY_BUF];
+        uint8_t  _head = 0;                       // next byte to write
+        uint8_t  _tail = 0;                       // next byte to transmit
+        uint16_t _seq  = 0;
+        uint16_t _dropped = 0;
+        uint8_t  _crc;
+
+        uint8_t _free();
+        bool    _begin(uint8_t type, uint8_t len);
+        void    _put(uint8_t b);
+        void    _put16(uint16_t w);
+        void    _put32(uint32_t l);
+        void    _end();
+};
+#endif
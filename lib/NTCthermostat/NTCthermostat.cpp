@@ -6,7 +6,19 @@
  *              and calls a callback function when the temperature falls below the lower limit 
  *              and calls another callback function when the temperature exceeds the upper limit.
  * 
- *              The monitoring cycle is determined by the user set interval.  
+ *              The thermostat keeps the state of the output. The output is turned on when
+ *              the temperature falls below the lower limit and turned off when it exceeds
+ *              the upper limit. The callbacks are only called on these transitions. A 
+ *              transition waits until the output has been in its state for the minimum  
+ *              on or off time, this protects relays and compressors.
+ * 
+ *              The monitoring cycle is determined by the user set interval. A deadline
+ *              based scheduler guarantees one tick per interval, late or missed ticks
+ *              are counted. The limits are kept in centi-°C and compared with integers, 
+ *              so the floating point and the fixed point build take the same decisions.
+ * 
+ *              In PID mode a PIDcontroller computes a duty cycle with each sample and 
+ *              the output is switched once on and once off in each PWM window.
  *                                                            
  * Board        Arduino uno, Wemos D1 R2
  * 
@@ -14,45 +26,445 @@
 
 #include "NTCthermostat.h"
 
+/**
+ * Convert °C to centi-°C, rounded
+ */
+static int16_t toCenti(float t)
+{
+    return (int16_t)(t * 100.0f + (t < 0.0f ? -0.5f : 0.5f));
+}
+
 void NTCthermostat::setLimitLow(float tLimitLow)
 {
-    _tLimitLow = tLimitLow;
+    _limits.cLimitLow = toCenti(tLimitLow);
 }
 
 void NTCthermostat::setLimitHigh(float tLimitHigh)
 {
-    _tLimitHigh = tLimitHigh;
+    _limits.cLimitHigh = toCenti(tLimitHigh);
 }
 
 float NTCthermostat::getLimitLow()
 {
-    return(_tLimitLow);
+    return(_limits.cLimitLow / 100.0f);
 }
 
 float NTCthermostat::getLimitHigh()
 {
-    return(_tLimitHigh);
+    return(_limits.cLimitHigh / 100.0f);
+}
+
+int16_t NTCthermostat::getCentiLimitLow()
+{
+    return _limits.cLimitLow;
+}
+
+int16_t NTCthermostat::getCentiLimitHigh()
+{
+    return _limits.cLimitHigh;
 }
 
 void NTCthermostat::setRefreshInterval(uint32_t msInterval)
 {
     _msRefresh = msInterval;
+    if (_adaptSlope == nullptr || _pid != nullptr) _scheduler.setInterval(msInterval);
+    if (_pid != nullptr) _pid->setSampleTime(msInterval);
+}
+
+uint32_t NTCthermostat::getRefreshInterval()
+{
+    return _msRefresh;
+}
+
+uint32_t NTCthermostat::getEffectiveInterval()
+{
+    return _scheduler.getInterval();
+}
+
+/**
+ * The interval is adapted from the next sample on, the slope 
+ * estimator gets every sample of the thermostat
+ */
+void NTCthermostat::useAdaptiveInterval(SlopeEstimator &slope, uint32_t msMin, uint32_t msMax)
+{
+    _adaptSlope = &slope;
+    _msAdaptMin = msMin > 0 ? msMin : 1;
+    _msAdaptMax = msMax > _msAdaptMin ? msMax : _msAdaptMin;
+    _adaptSlope->reset();
+}
+
+void NTCthermostat::disableAdaptiveInterval()
+{
+    _adaptSlope = nullptr;
+    _scheduler.setInterval(_msRefresh);
+}
+
+bool NTCthermostat::isAdaptive()
+{
+    return _adaptSlope != nullptr && _pid == nullptr;
+}
+
+/**
+ * Time to the limit which switches next at the current slope, sampled
+ * NTC_ADAPT_SAMPLES times, with an anticipator to its projection. Beyond
+ * the limit the output waits for its minimum time, the next sample is 
+ * due when that is over. The next tick follows the sample's tick.
+ */
+void NTCthermostat::_adaptInterval(const Reading &r)
+{
+    _adaptSlope->add(r.ms, r.cCelsius);
+
+    int32_t  cDist = _isOutputOn ? _limits.cLimitHigh - _cOffOf(r.cCelsius) : r.cCelsius - _limits.cLimitLow;
+    uint32_t ms;
+    if (cDist <= 0)
+    {
+        uint32_t msMin     = _isOutputOn ? _limits.msMinOn : _limits.msMinOff;
+        uint32_t msInState = r.ms - _msSwitched;
+        ms = msInState < msMin ? msMin - msInState : 0;
+    }
+    else
+    {
+        int32_t slope = _adaptSlope->getSlope();
+        if (slope < 0) slope = -slope;
+        if (slope < NTC_ADAPT_SLOPE_MIN) slope = NTC_ADAPT_SLOPE_MIN;
+        ms = (uint32_t)cDist * 60000UL / (uint32_t)slope / NTC_ADAPT_SAMPLES;
+    }
+    if (ms < _msAdaptMin) ms = _msAdaptMin;
+    if (ms > _msAdaptMax) ms = _msAdaptMax;
+    _scheduler.setInterval(ms);
+}
+
+uint32_t NTCthermostat::getLateTicks()
+{
+    return _scheduler.getLateTicks();
 }
 
+uint32_t NTCthermostat::getMissedTicks()
+{
+    return _scheduler.getMissedTicks();
+}
+
+uint32_t NTCthermostat::getMaxLateness()
+{
+    return _scheduler.getMaxLateness();
+}
+
+/**
+ * A tick starts a new sample. With oversampling the sensor makes one
+ * conversion per call of loop() until the sample is complete, then the
+ * limits are checked or the PID controller is computed. The PWM window 
+ * is checked on every call.
+ */
 void NTCthermostat::loop()
 {
-  if((millis() % _msRefresh) == 0 && _isEnabled) 
+#ifdef NTC_STATS
+  uint32_t usStart = micros();
+  if (_stats.loops > 0)
+  {
+    uint32_t usPeriod = usStart - _usLoopLast;
+    if (usPeriod > _stats.usLoopMax) _stats.usLoopMax = usPeriod;
+    _usLoopAvgQ4 += usPeriod - (_usLoopAvgQ4 >> 4);
+    _stats.usLoopAvg = _usLoopAvgQ4 >> 4;
+  }
+  _usLoopLast = usStart;
+  _stats.loops++;
+  bool isTicking = _isSampling;
+#endif
+  if (! _isEnabled) return;
+  if (! _isSampling && _scheduler.isDue(millis()))
+  {
+    _ntcSensor.startSampling();
+    _isSampling = true;
+#ifdef NTC_STATS
+    isTicking = true;
+    _stats.ticks++;
+    _usTickSum = 0;
+    _tickConversions = _ntcSensor.getStats().conversions;
+#endif
+  }
+  if (_isSampling && _ntcSensor.update())
+  {
+    _isSampling = false;
+    _reading = _ntcSensor.getReading();             // callbacks get the same sample
+    if (_filter.apply != nullptr) _applyFilter(_reading);
+    if (_pid != nullptr)
+    {
+      _callDuty(_pid->compute(_reading.cCelsius));
+    }
+    else 
+    {
+      _switchOutput(_reading);
+      if (_adaptSlope != nullptr) _adaptInterval(_reading);
+    }
+    _call(_onDataReady);
+  }
+  if (_pid != nullptr && _msWindow > 0) _switchWindow(millis());
+#ifdef NTC_STATS
+  if (isTicking)
+  {
+    _usTickSum += micros() - usStart;
+    if (! _isSampling)                              // tick complete
+    {
+      uint32_t conversions = _ntcSensor.getStats().conversions - _tickConversions;
+      _stats.conversions = conversions > UINT16_MAX ? UINT16_MAX : conversions;
+      if (_stats.conversions > _stats.conversionsMax) _stats.conversionsMax = _stats.conversions;
+      _stats.usTick = _usTickSum;
+      if (_usTickSum > _stats.usTickMax) _stats.usTickMax = _usTickSum;
+    }
+  }
+#endif
+}
+
+/**
+ * Time until the next tick or the next edge of the PWM window, 0 while 
+ * a sample is in progress. UINT32_MAX if the thermostat is disabled.
+ */
+uint32_t NTCthermostat::msUntilDue(uint32_t msNow)
+{
+  if (! _isEnabled) return UINT32_MAX;
+  if (_isSampling) return 0;
+
+  uint32_t ms = _scheduler.msUntilDue(msNow);
+  if (_pid != nullptr && _msWindow > 0)
   {
-    float t = _ntcSensor.getCelsius();
-    _onDataReady();
-    if (t < _tLimitLow) _onLowTemp();
-    if (t > _tLimitHigh) _onHighTemp();
+    uint32_t msInWindow = msNow - _msWindowStart;
+    if (msInWindow >= _msWindow) return 0;                // a new window begins
+    uint32_t msOn   = _msOnInWindow();
+    uint32_t msEdge = msInWindow < msOn ? msOn - msInWindow : _msWindow - msInWindow;
+    if (msEdge < ms) ms = msEdge;
   }
+  return ms;
+}
+
+/**
+ * Time proportional output: on for duty * msWindow at the beginning 
+ * of each window, pulses shorter than the minimum times are dropped
+ */
+void NTCthermostat::_switchWindow(uint32_t msNow)
+{
+  uint32_t msInWindow = msNow - _msWindowStart;
+  if (msInWindow >= _msWindow)
+  {
+    _msWindowStart += msInWindow - msInWindow % _msWindow;
+    msInWindow %= _msWindow;
+  }
+  if ((msInWindow < _msOnInWindow()) != _isOutputOn) _setOutput(! _isOutputOn, msNow);
+}
+
+/**
+ * On time in the PWM window from the duty cycle
+ */
+uint32_t NTCthermostat::_msOnInWindow()
+{
+  uint16_t duty = _pid->getOutput();
+  uint32_t msOn = (_msWindow / PID_OUT_MAX) * duty + (_msWindow % PID_OUT_MAX) * duty / PID_OUT_MAX;
+  if (msOn < _limits.msMinOn) msOn = 0;
+  else if (_msWindow - msOn < _limits.msMinOff) msOn = _msWindow;
+  return msOn;
+}
+
+void NTCthermostat::_setOutput(bool isOn, uint32_t msNow)
+{
+  _isOutputOn = isOn;
+  _msSwitched = msNow;
+  _switchCount++;
+  _call(isOn ? _onLowTemp : _onHighTemp);
+}
+
+void NTCthermostat::_call(Callback cb)
+{
+  if (cb == nullptr) return;
+#ifdef NTC_STATS
+  uint32_t usStart = micros();
+  cb(_ctx, _reading);
+  _countCallback(usStart);
+#else
+  cb(_ctx, _reading);
+#endif
+}
+
+void NTCthermostat::_callDuty(uint16_t duty)
+{
+  if (_onDuty == nullptr) return;
+#ifdef NTC_STATS
+  uint32_t usStart = micros();
+  _onDuty(_ctx, duty);
+  _countCallback(usStart);
+#else
+  _onDuty(_ctx, duty);
+#endif
+}
+
+#ifdef NTC_STATS
+void NTCthermostat::_countCallback(uint32_t usStart)
+{
+  uint32_t us = micros() - usStart;
+  _stats.usCallback += us;
+  if (us > _stats.usCallbackMax) _stats.usCallbackMax = us;
+}
+#endif
+
+/**
+ * Without NTC_STATS only the counters of the scheduler and the output 
+ * are filled in, the others are 0
+ */
+ThermostatStats NTCthermostat::getStats()
+{
+#ifdef NTC_STATS
+  ThermostatStats stats = _stats;
+#else
+  ThermostatStats stats = {};
+#endif
+  stats.lateTicks     = _scheduler.getLateTicks();
+  stats.missedTicks   = _scheduler.getMissedTicks();
+  stats.msMaxLateness = _scheduler.getMaxLateness();
+  stats.switchCount   = _switchCount;
+  return stats;
+}
+
+/**
+ * Resets the measured values, the counters of the scheduler and 
+ * the output keep counting
+ */
+void NTCthermostat::resetStats()
+{
+#ifdef NTC_STATS
+  _stats = {};
+  _usLoopAvgQ4 = 0;
+#endif
+}
+
+/**
+ * Replace the temperature of the sample by the filtered one
+ */
+void NTCthermostat::_applyFilter(Reading &r)
+{
+  r.cCelsius = _filter.apply(_filter.ctx, r.cCelsius);
+#ifndef NTC_FIXED_POINT
+  r.celsius    = r.cCelsius / 100.0;
+  r.kelvin     = r.celsius + 273.15;
+  r.fahrenheit = r.celsius * 9.0 / 5.0 + 32.0;
+#endif
+}
+
+void NTCthermostat::setFilter(const Filter &filter)
+{
+  _filter = filter;
+}
+
+void NTCthermostat::disableFilter()
+{
+  _filter = {};
+}
+
+/**
+ * Switch to PID mode. The sample time of the controller is the refresh 
+ * interval, the controller starts bumpless from the state of the output.
+ */
+void NTCthermostat::usePID(PIDcontroller &pid, uint32_t msWindow, DutyCallback onDuty)
+{
+  _pid      = &pid;
+  _onDuty   = onDuty;
+  _msWindow = msWindow;
+  _msWindowStart = millis();
+  _scheduler.setInterval(_msRefresh);
+  _pid->setSampleTime(_msRefresh);
+  _pid->reset(_isOutputOn ? PID_OUT_MAX : 0);
+}
+
+void NTCthermostat::disablePID()
+{
+  _pid = nullptr;
+}
+
+bool NTCthermostat::isPID()
+{
+  return _pid != nullptr;
+}
+
+uint16_t NTCthermostat::getDuty()
+{
+  return _pid != nullptr ? _pid->getOutput() : (_isOutputOn ? PID_OUT_MAX : 0);
+}
+
+void NTCthermostat::useAnticipator(NTCanticipator &anticipator)
+{
+  _anticipator = &anticipator;
+}
+
+void NTCthermostat::disableAnticipator()
+{
+  _anticipator = nullptr;
+}
+
+/**
+ * Hysteresis between the two limits. The output changes its state only 
+ * if it has been on for msMinOn or off for msMinOff. With an anticipator
+ * the output is also switched off when the projected temperature
+ * exceeds the upper limit.
+ */
+void NTCthermostat::_switchOutput(const Reading &r)
+{
+  if (_anticipator != nullptr) _anticipator->add(r);
+  bool isOn = onOffOutput(_isOutputOn, r.cCelsius, _cOffOf(r.cCelsius), _limits, r.ms - _msSwitched, _switchCount == 0);
+  if (isOn == _isOutputOn) return;
+  _setOutput(isOn, r.ms);
+  if (! isOn && _anticipator != nullptr) _anticipator->switchedOff(_limits.cLimitHigh);
+}
+
+/**
+ * Temperature compared with the upper limit, the projection of the
+ * anticipator if it is higher
+ */
+int16_t NTCthermostat::_cOffOf(int16_t cCelsius)
+{
+  if (_anticipator == nullptr) return cCelsius;
+  int16_t cProjected = _anticipator->project(cCelsius);
+  return cProjected > cCelsius ? cProjected : cCelsius;
+}
+
+bool onOffOutput(bool isOn, int16_t cOn, int16_t cOff, const OnOffLimits &limits, uint32_t msInState, bool isFirst)
+{
+  if (! isFirst && msInState < (isOn ? limits.msMinOn : limits.msMinOff)) return isOn;
+  if (! isOn) return cOn < limits.cLimitLow;
+  return ! (cOff > limits.cLimitHigh);
+}
+
+bool NTCthermostat::isOutputOn()
+{
+  return _isOutputOn;
+}
+
+void NTCthermostat::setMinOnTime(uint32_t msMinOn)
+{
+  _limits.msMinOn = msMinOn;
+}
+
+void NTCthermostat::setMinOffTime(uint32_t msMinOff)
+{
+  _limits.msMinOff = msMinOff;
+}
+
+uint32_t NTCthermostat::getMinOnTime()
+{
+  return _limits.msMinOn;
+}
+
+uint32_t NTCthermostat::getMinOffTime()
+{
+  return _limits.msMinOff;
+}
+
+uint32_t NTCthermostat::getSwitchCount()
+{
+  return _switchCount;
 }
 
 void NTCthermostat::enable()
 {
-  _isEnabled = true;
+  if (! _isEnabled) _scheduler.start(millis());  // first tick on the next loop()
+  _isEnabled  = true;
+  _isSampling = false;
 }
 
 void NTCthermostat::disable()
@@ -6,23 +6,107 @@
  * 
  * Constructor
  * arguments    &ntc          a reference to a NTCsensor object
- *              onLowTemp     a callback function to be called when temperature is below lower limit
- *              onHighTemp    a callback function to be called when temperature is above upper limit
+ *              onLowTemp     a callback function to be called when temperature falls below lower limit
+ *                            and the output is turned on
+ *              onHighTemp    a callback function to be called when temperature exceeds upper limit
+ *                            and the output is turned off
+ *              onDataReady   a callback function to be called with each new sample
+ *              ctx           a pointer passed to the callbacks, e.g. the object they act on
+ * 
+ * Callbacks    void callback(void *ctx, const Reading &reading)
+ *              reading is the sample the thermostat decided on, so the callbacks
+ *              need no conversion of their own. Callbacks may be nullptr.
+ * 
+ * Filter       setFilter() puts a filter between sensor and thermostat, e.g. one of 
+ *              NTCfilter. The limits are then compared with the filtered temperature 
+ *              and the callbacks get the filtered reading.
+ * 
+ * PID mode     usePID() replaces the two limits by a PIDcontroller which is computed 
+ *              with each sample. Its duty cycle drives the output as a slow PWM: in each 
+ *              window of msWindow ms the output is on for duty * msWindow, switched 
+ *              with onLowTemp (on) and onHighTemp (off). Pulses shorter than the minimum 
+ *              on or off time are dropped. With msWindow = 0 only onDuty is called with 
+ *              each new duty cycle, e.g. to set a hardware PWM pin.
+ * 
+ * Anticipator useAnticipator() switches the output off as soon as the temperature projected
+ *              by an NTCanticipator exceeds the upper limit, so the heat still on its way
+ *              doesn't overshoot the limit. Only in on/off mode.
+ * 
+ * Adaptive     useAdaptiveInterval() adapts the interval after each sample, so that the limit 
+ * interval     which switches next is reached in no less than NTC_ADAPT_SAMPLES samples at the 
+ *              temperature slope of a SlopeEstimator, between msMin and msMax. Near a limit or 
+ *              in a fast transient the thermostat samples often, in a stable room rarely, and
+ *              msUntilDue() lets a PowerManager sleep longer. getEffectiveInterval() returns
+ *              the interval in use, getRefreshInterval() the one set. Only in on/off mode,
+ *              the PID controller needs a fixed sample time.
+ * 
+ * Stats        getStats() returns the counters of the scheduler and the output. With the 
+ *              build flag NTC_STATS it also measures loop(), the ticks and the callbacks,
+ *              which costs two calls of micros() per measured section.
  */
 
 #ifndef _NTCTHERMOSTAT_H_
 #define _NTCTHERMOSTAT_H_
 #include <Arduino.h>
 #include "NTCsensor.h"
+#include "TickScheduler.h"
+#include "PIDcontroller.h"
+#include "NTCanticipator.h"
 
-//typedef void (*CallbackFunction)();
-using Callback = void (&)();
+#ifndef NTC_ADAPT_SAMPLES
+  #define NTC_ADAPT_SAMPLES   4     // samples at least until the next limit is reached
+#endif
+#ifndef NTC_ADAPT_SLOPE_MIN
+  #define NTC_ADAPT_SLOPE_MIN 2     // centi-°C per minute, a flatter slope counts as this
+#endif
+
+using Callback = void (*)(void *ctx, const Reading &reading);
+
+/**
+ * Filter stage
+ * apply       returns the filtered temperature in centi-°C, called once per sample
+ * ctx         passed to apply, e.g. the filter object
+ */
+using Filter = struct filter { int16_t (*apply)(void *ctx, int16_t cCelsius); void *ctx; };
+
+/**
+ * Limits in centi-°C and minimum on / off times of an on/off output
+ */
+using OnOffLimits = struct onOffLimits { int16_t cLimitLow; int16_t cLimitHigh; uint32_t msMinOn; uint32_t msMinOff; };
+
+/**
+ * On/off control with hysteresis, shared by NTCthermostat and ThermostatManager. 
+ * Returns the new state of the output: on below the lower limit, off above the 
+ * upper limit, the state is kept until it has lasted msMinOn or msMinOff. cOn is 
+ * compared with the lower, cOff with the upper limit, usually both the temperature.
+ */
+bool onOffOutput(bool isOn, int16_t cOn, int16_t cOff, const OnOffLimits &limits, uint32_t msInState, bool isFirst);
+
+// Called with the duty cycle 0 .. PID_OUT_MAX ‰ in PID mode
+using DutyCallback = void (*)(void *ctx, uint16_t duty);
+
+/**
+ * Instrumentation, the fields marked * are only counted with NTC_STATS
+ * ticks            * samples started
+ * conversions      * ADC conversions of the last tick, conversionsMax the most of one tick
+ * usTick           * µs in loop() for the last tick incl. callbacks, usTickMax longest
+ * usCallback       * µs in the callbacks, total, usCallbackMax longest call
+ * loops            * calls of loop()
+ * usLoopAvg        * period between calls of loop(), moving average over 16 calls
+ * usLoopMax        * longest period between calls of loop()
+ * lateTicks, missedTicks, msMaxLateness   as getLateTicks() .. getMaxLateness()
+ * switchCount      transitions of the output
+ */
+using ThermostatStats = struct thermostatStats { 
+    uint32_t ticks; uint16_t conversions; uint16_t conversionsMax; uint32_t usTick; uint32_t usTickMax;
+    uint32_t usCallback; uint32_t usCallbackMax; uint32_t loops; uint32_t usLoopAvg; uint32_t usLoopMax;
+    uint32_t lateTicks; uint32_t missedTicks; uint32_t msMaxLateness; uint32_t switchCount; };
 
 class NTCthermostat
 {
     public:
-        NTCthermostat(NTCsensor &ntcSensor, Callback onLowTemp, Callback onHighTemp, Callback onDataReady) : 
-                      _ntcSensor(ntcSensor), _onLowTemp(onLowTemp), _onHighTemp(onHighTemp), _onDataReady(onDataReady) 
+        NTCthermostat(NTCsensor &ntcSensor, Callback onLowTemp, Callback onHighTemp, Callback onDataReady, void *ctx = nullptr) : 
+                      _ntcSensor(ntcSensor), _onLowTemp(onLowTemp), _onHighTemp(onHighTemp), _onDataReady(onDataReady), _ctx(ctx) 
                        {}
 
         void  loop();
@@ -34,16 +118,77 @@ class NTCthermostat
         void  setRefreshInterval(uint32_t msInterval);
         float getLimitLow();
         float getLimitHigh();
+        int16_t getCentiLimitLow();   // limits in centi-°C
+        int16_t getCentiLimitHigh();
         uint32_t getRefreshInterval();
+        uint32_t getEffectiveInterval();  // interval in use, adapted in adaptive mode
+        void     useAdaptiveInterval(SlopeEstimator &slope, uint32_t msMin, uint32_t msMax);
+        void     disableAdaptiveInterval();  // back to the refresh interval
+        bool     isAdaptive();
+        uint32_t getLateTicks();      // ticks that were executed after their due time
+        uint32_t getMissedTicks();    // ticks skipped because loop() was not called in time
+        uint32_t getMaxLateness();    // largest delay of a tick in ms
+        uint32_t msUntilDue(uint32_t msNow);  // time loop() has nothing to do, e.g. to sleep
+        bool     isOutputOn();        // state of the output, e.g. the heating
+        void     setMinOnTime(uint32_t msMinOn);    // min. time the output stays on
+        void     setMinOffTime(uint32_t msMinOff);  // min. time the output stays off
+        uint32_t getMinOnTime();
+        uint32_t getMinOffTime();
+        uint32_t getSwitchCount();    // number of transitions of the output
+        void     setFilter(const Filter &filter);  // filter the temperature before the limits are checked
+        void     disableFilter();
+        void     usePID(PIDcontroller &pid, uint32_t msWindow, DutyCallback onDuty = nullptr);  // PID instead of on/off
+        void     disablePID();        // back to on/off at the limits
+        bool     isPID();
+        uint16_t getDuty();           // duty cycle in ‰ in PID mode
+        void     useAnticipator(NTCanticipator &anticipator);  // switch off early at the projected temperature
+        void     disableAnticipator();
+        ThermostatStats getStats();   // instrumentation, see NTC_STATS
+        void     resetStats();
 
     private:
         bool     _isEnabled = false;
-        float    _tLimitLow  = 18.0;
-        float    _tLimitHigh = 21.0;
-        uint32_t _msRefresh = 5000;
+        bool     _isSampling = false;   // a sample is in progress
+        OnOffLimits _limits = { 1800, 2100, 0, 0 };  // limits in centi-°C, compared with Reading.cCelsius
+        uint32_t _msRefresh = 5000;     // refresh interval set
+        TickScheduler _scheduler = TickScheduler(5000);  // effective interval
         NTCsensor &_ntcSensor;
-        Callback _onLowTemp;    // called when temperature is below lowwer limit
-        Callback _onHighTemp;   // called when temperature is above upper limit 
+        Callback _onLowTemp;    // called when temperature falls below lower limit
+        Callback _onHighTemp;   // called when temperature exceeds upper limit 
         Callback _onDataReady;
+        void    *_ctx;          // passed to the callbacks
+        Filter   _filter = {};  // no filter if _filter.apply == nullptr
+        Reading  _reading = {}; // sample the thermostat decided on
+        PIDcontroller *_pid = nullptr;  // on/off mode if nullptr
+        DutyCallback _onDuty = nullptr;
+        uint32_t _msWindow      = 0;    // PWM window, 0 for onDuty only
+        uint32_t _msWindowStart = 0;
+        NTCanticipator *_anticipator = nullptr;
+        SlopeEstimator *_adaptSlope  = nullptr;  // fixed interval if nullptr
+        uint32_t _msAdaptMin    = 0;
+        uint32_t _msAdaptMax    = 0;
+        bool     _isOutputOn  = false;
+        uint32_t _msSwitched  = 0;      // time of the last transition
+        uint32_t _switchCount = 0;
+
+        void     _switchOutput(const Reading &r);
+        int16_t  _cOffOf(int16_t cCelsius);
+        void     _applyFilter(Reading &r);
+        void     _switchWindow(uint32_t msNow);
+        void     _adaptInterval(const Reading &r);
+        uint32_t _msOnInWindow();
+        void     _setOutput(bool isOn, uint32_t msNow);
+        void     _call(Callback cb);   // callbacks with the sample, timed with NTC_STATS
+        void     _callDuty(uint16_t duty);
+
+      #ifdef NTC_STATS
+        ThermostatStats _stats = {};
+        uint32_t _usLoopLast     = 0;   // start of the last call of loop()
+        uint32_t _usLoopAvgQ4    = 0;   // moving average, scaled by 16
+        uint32_t _usTickSum      = 0;   // µs in loop() for the tick in progress
+        uint32_t _tickConversions = 0;  // conversions of the sensor when the tick began
+
+        void     _countCallback(uint32_t usStart);
+      #endif
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+/**
+ * Class        NTCtrace.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the classes TraceWriter and TraceReader, see NTCtrace.h
+ *
+ * Zigzag       The difference d of two analog values is mapped to an unsigned number,
+ *              0, -1, 1, -2, 2 .. to 0, 1, 2, 3, 4 .., so small differences of either
+ *              sign take one byte: z = (d << 1) ^ (d >> 31), d = (z >> 1) ^ -(z & 1)
+ *
+ * Board        Arduino UNO R3, Wemos D1 R2, ESP32 DevKit V1, native
+ */
+
+#include "NTCtrace.h"
+
+void TraceWriter::begin(uint32_t msStart)
+{
+    _len     = 0;
+    _msLast  = msStart;
+    _aLast   = 0;
+    _records = 0;
+    _bytes   = 0;
+    _lost    = 0;
+    _put('N');
+    _put('T');
+    _put(NTC_TRACE_VERSION);
+    _put(0);
+    for (uint8_t i = 0; i < 4; i++) _put((uint8_t)(msStart >> (8 * i)));
+}
+
+void TraceWriter::write(uint32_t ms, uint16_t aval)
+{
+    int32_t d = (int32_t)aval - (int32_t)_aLast;
+
+    _putVarint(ms - _msLast);
+    _putVarint(((uint32_t)d << 1) ^ (uint32_t)(d >> 31));
+    _msLast = ms;
+    _aLast  = aval;
+    _records++;
+}
+
+/**
+ * A sink which takes fewer bytes loses them. The trace is truncated 
+ * there: the deltas which follow would decode to wrong values, so 
+ * _put() drops all later bytes and the reader stops at the loss.
+ */
+void TraceWriter::flush()
+{
+    if (_len == 0) return;
+    size_t n = _sink.write(_sink.ctx, _buf, _len);
+    if (n < _len) _lost += _len - n;
+    _len = 0;
+}
+
+uint32_t TraceWriter::getRecords()
+{
+    return _records;
+}
+
+uint32_t TraceWriter::getBytes()
+{
+    return _bytes;
+}
+
+uint32_t TraceWriter::getLost()
+{
+    return _lost;
+}
+
+void TraceWriter::_put(uint8_t b)
+{
+    _bytes++;
+    if (_lost == 0 && _len == NTC_TRACE_BUF) flush();
+    if (_lost > 0)                                    // truncated until the next begin()
+    {
+        _lost++;
+        return;
+    }
+    _buf[_len++] = b;
+}
+
+void TraceWriter::_putVarint(uint32_t v)
+{
+    while (v >= 0x80)
+    {
+        _put((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    _put((uint8_t)v);
+}
+
+/**
+ * Check the header and decode the first record
+ */
+void TraceReader::rewind()
+{
+    _isValid = _size >= NTC_TRACE_HEADER && _data[0] == 'N' && _data[1] == 'T' && _data[2] == NTC_TRACE_VERSION;
+    _hasNext = false;
+    if (! _isValid) return;
+    _msStart = 0;
+    for (uint8_t i = 0; i < 4; i++) _msStart |= (uint32_t)_data[4 + i] << (8 * i);
+    _pos  = NTC_TRACE_HEADER;
+    _ms   = _msStart;
+    _aval = 0;
+    _decode();
+}
+
+bool TraceReader::isValid()
+{
+    return _isValid;
+}
+
+bool TraceReader::available()
+{
+    return _hasNext;
+}
+
+uint32_t TraceReader::msNext()
+{
+    return _msNext;
+}
+
+bool TraceReader::next(uint32_t &ms, uint16_t &aval)
+{
+    if (! _hasNext) return false;
+    ms    = _ms   = _msNext;
+    aval  = _aval = _avalNext;
+    _decode();
+    return true;
+}
+
+uint32_t TraceReader::getStart()
+{
+    return _msStart;
+}
+
+void TraceReader::_decode()
+{
+    uint32_t dt, z;
+
+    _hasNext = _getVarint(dt) && _getVarint(z);
+    if (! _hasNext) return;
+    _msNext   = _ms + dt;
+    _avalNext = (uint16_t)((int32_t)_aval + (int32_t)((z >> 1) ^ (0 - (z & 1))));
+}
+
+bool TraceReader::_getVarint(uint32_t &v)
+{
+    v = 0;
+    for (uint8_t shift = 0; shift < 35 && _pos < _size; shift += 7)
+    {
+        uint8_t b = _data[_pos++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (! (b & 0x80)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,167 @@
+/**
+ * Header       NTCtrace.h
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Declaration of the classes TraceWriter, TraceReader, TraceRecorder and
+ *              TraceReplay. A trace is a compact binary record of the conversions of an
+ *              ADC with their time. It is recorded on the board to the serial port or to
+ *              a file on SD / SPIFFS and replayed through NTCsensor and NTCthermostat on
+ *              the native build, faster than real time, to tune limits, filters and the
+ *              PID controller offline (see bench/replay).
+ *
+ * Usage        Record
+ *              TraceWriter trace(sinkOf(file));           // any class with write(data, len)
+ *              AdcBuiltin  adcPin(adcUno);
+ *              TraceRecorder<AdcBuiltin> recorder(adcPin, trace);
+ *              ntcSensor.useSource(recorder);               // sets up the pin, one conversion per update()
+ *              trace.begin(millis());                       // and trace.flush() from time to time
+ *
+ *              Replay with virtual time, e.g. halSetMillis() of bench/hal
+ *              TraceReader reader(data, size);
+ *              TraceReplay replay(reader);
+ *              ntcSensor.useSource(replay);                 // conversions at their recorded time
+ *
+ * Format       header  'N' 'T' version flags  msStart u32    little endian
+ *              record  dt  varint   ms since the previous record (since msStart)
+ *                      da  varint   zigzag encoded difference to the previous analog value
+ *              varint: 7 bits per byte, least significant first, bit 7 set if more follow.
+ *              A conversion of an oversampled block takes 2 bytes, mostly 1 + 1.
+ *
+ * Remarks      The replay is open loop: the recorded temperature does not react to the
+ *              output of the replayed thermostat. Switch counts, delays and the response
+ *              to noise are meaningful, the regulated temperature is not. Replay with the
+ *              refresh interval of the recording.
+ */
+#ifndef _NTCTRACE_H_
+#define _NTCTRACE_H_
+#include <Arduino.h>
+#include "NTCsensor.h"
+
+#ifndef NTC_TRACE_BUF
+  #define NTC_TRACE_BUF 32          // bytes buffered before they are passed to the sink
+#endif
+
+#define NTC_TRACE_VERSION  1
+#define NTC_TRACE_HEADER   8        // bytes of the header
+
+/**
+ * Destination of a trace
+ * write       writes len bytes, returns the number written
+ * ctx         passed to write, e.g. the file or the serial port
+ */
+using TraceSink = struct traceSink { size_t (*write)(void *ctx, const uint8_t *data, size_t len); void *ctx; };
+
+/**
+ * Sink of any class with write(const uint8_t *data, size_t len), e.g.
+ * HardwareSerial or File. out has to live as long as the sink.
+ */
+template <class Out>
+TraceSink sinkOf(Out &out)
+{
+    return { [](void *ctx, const uint8_t *data, size_t len) -> size_t { return static_cast<Out *>(ctx)->write(data, len); }, &out };
+}
+
+class TraceWriter
+{
+    public:
+        TraceWriter(const TraceSink &sink) : _sink(sink) {}
+
+        void     begin(uint32_t msStart);             // writes the header
+        void     write(uint32_t ms, uint16_t aval);   // one conversion
+        void     flush();                             // passes the buffered bytes to the sink
+        uint32_t getRecords();
+        uint32_t getBytes();
+        uint32_t getLost();                           // bytes missing, the trace ends at the first loss
+
+    private:
+        TraceSink _sink;
+        uint8_t   _buf[NTC_TRACE_BUF];
+        uint8_t   _len    = 0;
+        uint32_t  _msLast = 0;
+        uint16_t  _aLast  = 0;
+        uint32_t  _records = 0;
+        uint32_t  _bytes   = 0;
+        uint32_t  _lost    = 0;
+
+        void _put(uint8_t b);
+        void _putVarint(uint32_t v);
+};
+
+class TraceReader
+{
+    public:
+        TraceReader(const uint8_t *data, size_t size) : _data(data), _size(size) { rewind(); }
+
+        bool     isValid();                           // header found
+        void     rewind();                            // back to the first record
+        bool     available();                         // a record follows
+        uint32_t msNext();                            // time of the next record
+        bool     next(uint32_t &ms, uint16_t &aval);  // false at the end or if the trace is truncated
+        uint32_t getStart();
+
+    private:
+        const uint8_t *_data;
+        size_t   _size;
+        size_t   _pos      = 0;
+        bool     _isValid  = false;
+        uint32_t _msStart  = 0;
+        uint32_t _ms       = 0;
+        uint16_t _aval     = 0;
+        uint32_t _msNext   = 0;       // decoded next record
+        uint16_t _avalNext = 0;
+        bool     _hasNext  = false;
+
+        void _decode();
+        bool _getVarint(uint32_t &v);
+};
+
+/**
+ * ADC policy which records the conversions of another policy
+ */
+template <class Adc>
+class TraceRecorder
+{
+    public:
+        TraceRecorder(Adc &adc, TraceWriter &writer) : _adc(adc), _writer(writer) {}
+
+        static const bool isBuffered = Adc::isBuffered;
+
+        void begin() { _adc.begin(); }
+
+        bool read(uint16_t &aval)
+        {
+            if (! _adc.read(aval)) return false;
+            _writer.write(millis(), aval);
+            return true;
+        }
+
+    private:
+        Adc         &_adc;
+        TraceWriter &_writer;
+};
+
+/**
+ * ADC policy which delivers the conversions of a trace when millis()
+ * has reached their recorded time
+ */
+class TraceReplay
+{
+    public:
+        TraceReplay(TraceReader &reader) : _reader(reader) {}
+
+        static const bool isBuffered = true;
+
+        void begin() {}
+
+        bool read(uint16_t &aval)
+        {
+            uint32_t ms;
+            if (! _reader.available() || (int32_t)(_reader.msNext() - millis()) > 0) return false;
+            return _reader.next(ms, aval);
+        }
+
+    private:
+        TraceReader &_reader;
+};
+
+#endif
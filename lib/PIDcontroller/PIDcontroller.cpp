@@ -0,0 +1,142 @@
+/**
+ * Class        PIDcontroller.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class PIDcontroller 
+ * 
+ * Equations    With e = setpoint - y, sample time Ts in s and the output in ‰:
+ * 
+ *              P    = kp * e                  kp = Kp * 10 / 100   ‰ per centi-°C
+ *              I   += ki * e                  ki = Ki * 10 / 100 * Ts
+ *              D    = -kd * (y - y_last)      kd = Kd * 10 / 100 / Ts
+ *              out  = P + I + D               clamped to 0 .. 1000
+ * 
+ *              kp, ki and kd are kept in Q16 and recalculated only when the tunings 
+ *              or the sample time change. The products are calculated with 64 bits, 
+ *              so large errors don't overflow.
+ * 
+ * Board        Arduino uno, Wemos D1 R2, ESP32 DevKit V1
+ * 
+ **/
+
+#include "PIDcontroller.h"
+
+static const int32_t outMaxQ16 = (int32_t)PID_OUT_MAX << 16;
+
+static int32_t clampQ16(int64_t v)
+{
+    if (v < 0) return 0;
+    if (v > outMaxQ16) return outMaxQ16;
+    return (int32_t)v;
+}
+
+/**
+ * Calculate the output from the measured temperature. Must be 
+ * called once per sample time, e.g. on each sample of the thermostat.
+ */
+uint16_t PIDcontroller::compute(int16_t cMeasured)
+{
+    int32_t e  = (int32_t)_cSetpoint - cMeasured;
+    int32_t dy = _hasLast ? (int32_t)cMeasured - _cLast : 0;
+
+    _cLast   = cMeasured;
+    _hasLast = true;
+
+    int64_t p   = (int64_t)_kp * e;
+    int64_t d   = -(int64_t)_kd * dy;
+    int64_t out = p + _iTerm + d;
+    int64_t di  = (int64_t)_ki * e;
+
+    // Anti-windup: don't integrate further into the saturation
+    if (! ((out >= outMaxQ16 && di > 0) || (out <= 0 && di < 0)))
+    {
+        _iTerm = clampQ16(_iTerm + di);
+        out    = p + _iTerm + d;
+    }
+    _output = (uint16_t)((clampQ16(out) + 32768L) >> 16);
+    return _output;
+}
+
+/**
+ * Restart the controller. The I-term takes over the output, so 
+ * switching from manual or on/off control causes no bump.
+ */
+void PIDcontroller::reset(uint16_t output)
+{
+    if (output > PID_OUT_MAX) output = PID_OUT_MAX;
+    _iTerm   = (int32_t)output << 16;
+    _output  = output;
+    _hasLast = false;
+}
+
+void PIDcontroller::setTunings(float Kp, float Ki, float Kd)
+{
+    _Kp = Kp < 0.0f ? 0.0f : Kp;
+    _Ki = Ki < 0.0f ? 0.0f : Ki;
+    _Kd = Kd < 0.0f ? 0.0f : Kd;
+    _scale();
+}
+
+void PIDcontroller::setSampleTime(uint32_t msSample)
+{
+    _msSample = msSample > 0 ? msSample : 1;
+    _scale();
+}
+
+/**
+ * Gains in Q16 ‰ per centi-°C. The I-term is part of the output, 
+ * so it stays valid when ki changes.
+ */
+void PIDcontroller::_scale()
+{
+    float ts = _msSample / 1000.0f;
+
+    _kp = (int32_t)lround(_Kp * 0.1f * 65536.0f);
+    _ki = (int32_t)lround(_Ki * 0.1f * ts * 65536.0f);
+    _kd = (int32_t)lround(_Kd * 0.1f / ts * 65536.0f);
+}
+
+void PIDcontroller::setSetpoint(float tSetpoint)
+{
+    _cSetpoint = (int16_t)(tSetpoint * 100.0f + (tSetpoint < 0.0f ? -0.5f : 0.5f));
+}
+
+void PIDcontroller::setCentiSetpoint(int16_t cSetpoint)
+{
+    _cSetpoint = cSetpoint;
+}
+
+float PIDcontroller::getSetpoint()
+{
+    return _cSetpoint / 100.0f;
+}
+
+int16_t PIDcontroller::getCentiSetpoint()
+{
+    return _cSetpoint;
+}
+
+uint16_t PIDcontroller::getOutput()
+{
+    return _output;
+}
+
+float PIDcontroller::getKp()
+{
+    return _Kp;
+}
+
+float PIDcontroller::getKi()
+{
+    return _Ki;
+}
+
+float PIDcontroller::getKd()
+{
+    return _Kd;
+}
+
+uint32_t PIDcontroller::getSampleTime()
+{
+    return _msSample;
+}
@@ -0,0 +1,60 @@
+/**
+ * Header       PIDcontroller.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration of the class PIDcontroller, an integer PID controller for
+ *              a temperature in centi-°C with an output of 0 .. 1000 ‰ (duty cycle).
+ * 
+ *              - derivative on measurement, a change of the setpoint causes no kick
+ *              - the I-term is kept as part of the output and clamped to the output 
+ *                range, it doesn't integrate further while the output is saturated 
+ *                in the same direction (anti-windup)
+ *              - changing the tunings doesn't bump the output
+ *              - no floating point per sample, the same result on AVR and ESP
+ * 
+ * Tunings      Kp   % per °C
+ *              Ki   % per °C and second
+ *              Kd   % per °C/s
+ * 
+ * Usage        PIDcontroller pid;
+ *              pid.setTunings(20.0, 0.05, 0.0);
+ *              pid.setSampleTime(5000);
+ *              pid.setSetpoint(21.5);
+ *              uint16_t duty = pid.compute(reading.cCelsius);  // once per sample time
+ */
+#ifndef _PIDCONTROLLER_H_
+#define _PIDCONTROLLER_H_
+#include <Arduino.h>
+
+#define PID_OUT_MAX 1000        // output 0 .. PID_OUT_MAX ‰
+
+class PIDcontroller
+{
+    public:
+        uint16_t compute(int16_t cMeasured);    // new output from the measured temperature
+        void     reset(uint16_t output = 0);    // restart, bumpless from output
+        void     setTunings(float Kp, float Ki, float Kd);
+        void     setSampleTime(uint32_t msSample);  // time between two calls of compute()
+        void     setSetpoint(float tSetpoint);
+        void     setCentiSetpoint(int16_t cSetpoint);
+        float    getSetpoint();
+        int16_t  getCentiSetpoint();
+        uint16_t getOutput();                   // last output in ‰
+        float    getKp();
+        float    getKi();
+        float    getKd();
+        uint32_t getSampleTime();
+
+    private:
+        float    _Kp = 0.0f, _Ki = 0.0f, _Kd = 0.0f;
+        uint32_t _msSample  = 5000;
+        int16_t  _cSetpoint = 2000;
+        int32_t  _kp = 0, _ki = 0, _kd = 0;  // Q16 ‰ per centi-°C, per sample
+        int32_t  _iTerm     = 0;         // Q16 ‰
+        int16_t  _cLast     = 0;         // last measurement
+        bool     _hasLast   = false;
+        uint16_t _output    = 0;
+
+        void _scale();
+};
+#endif
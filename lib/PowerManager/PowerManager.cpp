@@ -0,0 +1,297 @@
+/**
+ * Class        PowerManager.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class PowerManager 
+ * 
+ * Equations    duty  = tAwake / (tAwake + tAsleep)
+ *              Imean = duty * Iactive + (1 - duty) * Isleep
+ * 
+ * Board        Arduino uno, Wemos D1 R2, ESP32 DevKit V1
+ * 
+ **/
+
+#include "PowerManager.h"
+
+#if defined(__AVR__)
+  #include <avr/sleep.h>
+  #include <avr/wdt.h>
+  #include <avr/interrupt.h>
+  extern volatile unsigned long timer0_millis;      // the counter behind millis()
+  ISR(WDT_vect) {}                                  // only wakes the MCU
+  #define RTC_STATE_ATTR
+#elif defined(ESP8266)
+  extern "C" {
+    #include "user_interface.h"
+  }
+  #define RTC_STATE_ATTR
+#elif defined(ESP32)
+  #include <esp_sleep.h>
+  #define RTC_STATE_ATTR RTC_DATA_ATTR
+#else
+  #define RTC_STATE_ATTR
+#endif
+
+static const uint16_t rtcMagic = 0x5254;            // "RT"
+
+// Retained state and statistics, in RTC memory on the ESP32
+RTC_STATE_ATTR static uint8_t  rtcData[NTC_RTC_STATE_MAX];
+RTC_STATE_ATTR static uint8_t  rtcLen;
+RTC_STATE_ATTR static uint8_t  rtcSum;
+#ifdef ESP32
+RTC_STATE_ATTR static uint16_t rtcStatsMagic;       // statistics across a deep sleep
+RTC_STATE_ATTR static uint32_t rtcMsAwake;
+RTC_STATE_ATTR static uint32_t rtcMsAsleep;
+#endif
+
+static uint8_t checksum(const uint8_t *p, uint8_t len)
+{
+    uint8_t sum = 0x5A;
+    while (len--) sum = (uint8_t)((sum << 1) | (sum >> 7)) ^ *p++;
+    return sum;
+}
+
+PowerManager::PowerManager(SleepMode mode) : _mode(mode)
+{
+    _setDefaultCurrents();
+    _msWake = millis();
+  #ifdef ESP32
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER && rtcStatsMagic == rtcMagic)
+    {
+        _isWakeFromDeepSleep = true;
+        _msAwake  = rtcMsAwake;
+        _msAsleep = rtcMsAsleep;
+    }
+  #endif
+}
+
+/**
+ * Sleep for about msSleep ms, e.g. the time until the next tick of
+ * the thermostat, at most the maximum sleep. Returns the time slept, 
+ * 0 if msSleep is shorter than the minimum sleep. SLEEP_DEEP on the 
+ * ESP32 doesn't return.
+ */
+uint32_t PowerManager::sleep(uint32_t msSleep)
+{
+    uint32_t ms = 0;
+
+    if (msSleep < _msMinSleep) return 0;
+    if (msSleep > _msMaxSleep) msSleep = _msMaxSleep;
+    _msAwake += millis() - _msWake;
+    switch (_mode)
+    {
+        case SLEEP_LIGHT: ms = _sleepLight(msSleep); break;
+        case SLEEP_DEEP:  ms = _sleepDeep(msSleep);  break;
+        default:          ms = _sleepIdle(msSleep);  break;
+    }
+    _msAsleep += ms;
+    _msWake    = millis();
+    return ms;
+}
+
+/**
+ * Ends early when a byte arrives at Serial, so requests are
+ * answered within a millisecond
+ */
+uint32_t PowerManager::_sleepIdle(uint32_t ms)
+{
+    uint32_t msStart = millis();
+
+  #ifdef __AVR__
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (millis() - msStart < ms && Serial.available() == 0) sleep_mode();  // woken by timer0 or the UART
+  #else
+    while (millis() - msStart < ms && Serial.available() == 0) delay(1);
+  #endif
+    return millis() - msStart;
+}
+
+#if defined(__AVR__)
+/**
+ * Power-down in steps of the watchdog, the rest in idle mode. 
+ * The watchdog periods are 16 ms * 2^p, p = 0 .. 9.
+ */
+uint32_t PowerManager::_sleepLight(uint32_t ms)
+{
+    uint32_t msSlept = 0;
+
+    Serial.flush();                                   // the UART stops in power-down
+    while (ms - msSlept >= 16)
+    {
+        uint8_t  p  = 9;
+        uint32_t msStep;
+        while ((msStep = 16UL << p) > ms - msSlept) p--;
+        
+        noInterrupts();
+        wdt_reset();
+        MCUSR  &= ~(1 << WDRF);
+        WDTCSR  = (1 << WDCE) | (1 << WDE);           // timed sequence to change the prescaler
+        WDTCSR  = (1 << WDIE) | ((p & 8) ? (1 << WDP3) : 0) | (p & 7);
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        sleep_enable();
+        interrupts();
+        sleep_cpu();
+        sleep_disable();
+        wdt_disable();
+
+        noInterrupts();
+        timer0_millis += msStep;                      // timer0 stood still
+        interrupts();
+        msSlept += msStep;
+    }
+    return msSlept + _sleepIdle(ms - msSlept);
+}
+#elif defined(ESP8266)
+static void onWakeup() {}
+
+/**
+ * The forced sleep needs the radio off, the mode before is restored 
+ * afterwards. WiFi reconnects by itself, which takes a few seconds.
+ */
+uint32_t PowerManager::_sleepLight(uint32_t ms)
+{
+    uint8_t mode = wifi_get_opmode();
+
+    Serial.flush();
+    wifi_set_opmode_current(NULL_MODE);
+    wifi_fpm_set_sleep_type(LIGHT_SLEEP_T);
+    wifi_fpm_open();
+    wifi_fpm_set_wakeup_cb(onWakeup);
+    wifi_fpm_do_sleep(ms * 1000UL);
+    delay(ms + 1);                                    // the sleep begins in delay()
+    wifi_fpm_close();
+    wifi_set_opmode_current(mode);
+    return ms;
+}
+#elif defined(ESP32)
+uint32_t PowerManager::_sleepLight(uint32_t ms)
+{
+    uint32_t msStart = millis();
+
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000ULL);
+    esp_light_sleep_start();                          // millis() is compensated
+    return millis() - msStart;
+}
+#else
+uint32_t PowerManager::_sleepLight(uint32_t ms)
+{
+    return _sleepIdle(ms);
+}
+#endif
+
+/**
+ * Deep sleep of the ESP32, the statistics are kept in RTC memory and
+ * setup() runs again after the sleep. The other boards sleep light.
+ */
+uint32_t PowerManager::_sleepDeep(uint32_t ms)
+{
+  #ifdef ESP32
+    rtcMsAwake    = _msAwake;
+    rtcMsAsleep   = _msAsleep + ms;
+    rtcStatsMagic = rtcMagic;
+    Serial.flush();
+    esp_deep_sleep((uint64_t)ms * 1000ULL);           // doesn't return
+  #endif
+    return _sleepLight(ms);
+}
+
+void PowerManager::setMode(SleepMode mode)
+{
+    _mode = mode;
+    _setDefaultCurrents();
+}
+
+void PowerManager::setMinSleep(uint32_t msMinSleep)
+{
+    _msMinSleep = msMinSleep;
+}
+
+void PowerManager::setMaxSleep(uint32_t msMaxSleep)
+{
+    _msMaxSleep = msMaxSleep;
+}
+
+/**
+ * Typical currents of the bare chip in mA
+ */
+void PowerManager::_setDefaultCurrents()
+{
+  #if defined(__AVR__)
+    _mAactive = 9.0f;                                 // ATmega328P 16 MHz 5 V
+    _mAsleep  = _mode == SLEEP_IDLE ? 3.5f : 0.006f;  // idle, power-down with watchdog
+  #elif defined(ESP8266)
+    _mAactive = 15.0f;                                // WiFi off
+    _mAsleep  = _mode == SLEEP_IDLE ? 15.0f : 0.5f;
+  #elif defined(ESP32)
+    _mAactive = 40.0f;                                // 240 MHz, WiFi off
+    _mAsleep  = _mode == SLEEP_IDLE ? 25.0f : (_mode == SLEEP_LIGHT ? 0.8f : 0.01f);
+  #else
+    _mAactive = 10.0f;
+    _mAsleep  = 1.0f;
+  #endif
+}
+
+void PowerManager::setCurrents(float mAactive, float mAsleep)
+{
+    _mAactive = mAactive;
+    _mAsleep  = mAsleep;
+}
+
+float PowerManager::getDutyCycle()
+{
+    uint32_t awake = getMsAwake();
+    uint32_t total = awake + _msAsleep;
+    return total > 0 ? (float)awake / total : 1.0f;
+}
+
+float PowerManager::getMeanCurrent()
+{
+    float duty = getDutyCycle();
+    return duty * _mAactive + (1.0f - duty) * _mAsleep;
+}
+
+/**
+ * Time awake including the time since the last wakeup
+ */
+uint32_t PowerManager::getMsAwake()
+{
+    return _msAwake + (millis() - _msWake);
+}
+
+uint32_t PowerManager::getMsAsleep()
+{
+    return _msAsleep;
+}
+
+void PowerManager::resetStats()
+{
+    _msAwake  = 0;
+    _msAsleep = 0;
+    _msWake   = millis();
+}
+
+bool PowerManager::isWakeFromDeepSleep()
+{
+    return _isWakeFromDeepSleep;
+}
+
+/**
+ * Keep len bytes of data, e.g. the state of a filter or a PID
+ * controller, in RTC memory for the next wakeup from deep sleep
+ */
+bool PowerManager::retain(const void *data, uint8_t len)
+{
+    if (len > NTC_RTC_STATE_MAX) return false;
+    memcpy(rtcData, data, len);
+    rtcLen = len;
+    rtcSum = checksum(rtcData, len);
+    return true;
+}
+
+bool PowerManager::recall(void *data, uint8_t len)
+{
+    if (len != rtcLen || len > NTC_RTC_STATE_MAX || rtcSum != checksum(rtcData, len)) return false;
+    memcpy(data, rtcData, len);
+    return true;
+}
@@ -0,0 +1,85 @@
+/**
+ * Header       PowerManager.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration of the class PowerManager which lets the MCU sleep while
+ *              the thermostat has nothing to do and reports the duty cycle and the 
+ *              estimated mean current.
+ * 
+ *              SLEEP_IDLE    Uno      idle, timer0 wakes every ms, millis() runs on
+ *                            ESP      delay() in steps of 1 ms
+ *                            Both end the sleep as soon as a byte arrives at Serial.
+ *              SLEEP_LIGHT   Uno      power-down, the watchdog wakes in steps of 16 ms .. 8 s,
+ *                                     the time slept is added to millis()
+ *                            ESP8266  forced light sleep with timer wakeup, WiFi is off and
+ *                                     reconnects after the sleep within a few seconds
+ *                            ESP32    light sleep with timer wakeup
+ *              SLEEP_DEEP    ESP32    deep sleep, the chip restarts after the sleep. 
+ *                                     retain() / recall() keep e.g. filter or PID state 
+ *                                     in RTC memory. Other boards use SLEEP_LIGHT.
+ * 
+ * Usage        PowerManager power(SLEEP_LIGHT);
+ *              loop()
+ *              {
+ *                  thermostat.loop();
+ *                  if (telemetry.isIdle()) power.sleep(thermostat.msUntilDue(millis()));
+ *              }
+ * 
+ *              A sleep is cut to NTC_SLEEP_MAX or setMaxSleep(), so a disabled thermostat,
+ *              whose msUntilDue() is UINT32_MAX, doesn't put the board to sleep for days.
+ *              In SLEEP_LIGHT and SLEEP_DEEP serial requests wait for the end of the sleep.
+ * 
+ * Remarks      The watchdog of the Uno is only accurate to about 10 %, so millis()
+ *              drifts in SLEEP_LIGHT. The serial port is flushed before a sleep in 
+ *              which its clock stops. The currents for the estimate are typical values 
+ *              of the bare chip, set the values measured on the board with setCurrents().
+ */
+#ifndef _POWERMANAGER_H_
+#define _POWERMANAGER_H_
+#include <Arduino.h>
+
+#ifndef NTC_SLEEP_MAX
+  #define NTC_SLEEP_MAX     60000UL   // ms, longest sleep
+#endif
+#ifndef NTC_RTC_STATE_MAX
+  #define NTC_RTC_STATE_MAX 64      // bytes retained in RTC memory across deep sleep (ESP32)
+#endif
+
+enum SleepMode { SLEEP_IDLE, SLEEP_LIGHT, SLEEP_DEEP };
+
+class PowerManager
+{
+    public:
+        PowerManager(SleepMode mode = SLEEP_IDLE);
+
+        uint32_t sleep(uint32_t msSleep);      // sleep about msSleep ms, returns the time slept
+        void     setMode(SleepMode mode);
+        void     setMinSleep(uint32_t msMinSleep);  // shorter sleeps are skipped
+        void     setMaxSleep(uint32_t msMaxSleep);  // longer sleeps are cut
+        void     setCurrents(float mAactive, float mAsleep);
+        float    getDutyCycle();               // fraction of the time awake
+        float    getMeanCurrent();             // in mA from the duty cycle and the currents
+        uint32_t getMsAwake();
+        uint32_t getMsAsleep();
+        void     resetStats();
+        bool     isWakeFromDeepSleep();        // true after a restart from SLEEP_DEEP
+        static bool retain(const void *data, uint8_t len);   // keep data in RTC memory
+        static bool recall(void *data, uint8_t len);         // false if nothing or other data was retained
+
+    private:
+        SleepMode _mode;
+        uint32_t  _msMinSleep = 2;
+        uint32_t  _msMaxSleep = NTC_SLEEP_MAX;
+        float     _mAactive;
+        float     _mAsleep;
+        uint32_t  _msAwake    = 0;
+        uint32_t  _msAsleep   = 0;
+        uint32_t  _msWake;                      // millis() at the last wakeup
+        bool      _isWakeFromDeepSleep = false;
+
+        void     _setDefaultCurrents();
+        uint32_t _sleepIdle(uint32_t ms);
+        uint32_t _sleepLight(uint32_t ms);
+        uint32_t _sleepDeep(uint32_t ms);
+};
+#endif
@@ -0,0 +1,92 @@
+/**
+ * Header       SpscQueue.h
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Declaration and implementation of the class template SpscQueue, a lock-free
+ *              queue of N items of type T for exactly one producer and one consumer, e.g.
+ *              an interrupt and the loop or two tasks on the two cores of the ESP32.
+ *
+ *              The producer only writes _head, the consumer only writes _tail. An item is
+ *              copied into its slot before _head is published with release semantics, the
+ *              consumer reads _head with acquire semantics before it reads the slot, and
+ *              the same in the other direction for _tail. Neither side ever waits, a full
+ *              queue rejects the item.
+ *
+ * Usage        SpscQueue<Reading, 32> queue;
+ *              producer   if (! queue.push(reading)) dropped++;
+ *              consumer   while (queue.pop(reading)) print(reading);
+ *
+ *              peek() and drop() let the consumer remove items only after it has handled
+ *              them, e.g. after a server has accepted them.
+ *
+ * Remarks      N is a power of 2 up to 256, the queue holds N - 1 items. The indices are
+ *              single bytes, so they are read and written atomically on AVR as well.
+ */
+#ifndef _SPSCQUEUE_H_
+#define _SPSCQUEUE_H_
+#include <Arduino.h>
+
+template <class T, uint16_t N>
+class SpscQueue
+{
+    static_assert((N & (N - 1)) == 0 && N >= 2 && N <= 256, "N must be a power of 2 from 2 to 256");
+
+    public:
+        /**
+         * Producer: false if the queue is full
+         */
+        bool push(const T &item)
+        {
+            uint8_t head = _head;
+            uint8_t next = (head + 1) & (N - 1);
+            if (next == __atomic_load_n(&_tail, __ATOMIC_ACQUIRE)) return false;
+            _items[head] = item;
+            __atomic_store_n(&_head, next, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        /**
+         * Consumer: false if the queue is empty
+         */
+        bool pop(T &item)
+        {
+            if (! peek(0, item)) return false;
+            drop(1);
+            return true;
+        }
+
+        /**
+         * Consumer: the i-th oldest item without removing it
+         */
+        bool peek(uint8_t i, T &item)
+        {
+            if (i >= count()) return false;
+            item = _items[(_tail + i) & (N - 1)];
+            return true;
+        }
+
+        /**
+         * Consumer: remove the n oldest items
+         */
+        void drop(uint8_t n)
+        {
+            uint8_t c = count();
+            if (n > c) n = c;
+            __atomic_store_n(&_tail, (uint8_t)((_tail + n) & (N - 1)), __ATOMIC_RELEASE);
+        }
+
+        // Consumer: items in the queue, the producer may add more meanwhile
+        uint8_t count()
+        {
+            return (__atomic_load_n(&_head, __ATOMIC_ACQUIRE) - _tail) & (N - 1);
+        }
+
+        bool isEmpty() { return count() == 0; }
+
+    private:
+        T       _items[N];
+        uint8_t _head = 0;          // next slot to write, written by the producer only
+        uint8_t _tail = 0;          // next slot to read, written by the consumer only
+};
+
+#endif
@@ -0,0 +1,206 @@
+/**
+ * Header       ThermostatManager.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration and implementation of the class template ThermostatManager
+ *              which runs the on/off control of N zones with one NTCsensorArray.
+ * 
+ *              The zones are kept in a packed array: limits in centi-°C, refresh 
+ *              interval, minimum on and off times and the state of the output. A 
+ *              min-heap holds the next due time of each zone. loop() only compares 
+ *              millis() with the top of the heap when nothing is due, so a pass costs 
+ *              the same for 1 or 16 zones. A due zone is sampled, its limits checked 
+ *              and it is put back into the heap in O(log N). One zone is sampled at 
+ *              a time, with oversampling one conversion per loop().
+ * 
+ *              start() staggers the first due times of the zones over their interval,
+ *              so the conversions and the switching of the relays don't pile up at 
+ *              the same moment.
+ * 
+ * Template
+ * arguments    N          number of zones, equal to the channels of the sensor array
+ * 
+ * Constructor
+ * arguments    &sensors   the NTCsensorArray, zone i uses channel i
+ *              onLowTemp  called when zone's temperature falls below its lower limit 
+ *                         and its output is turned on
+ *              onHighTemp called when it exceeds its upper limit, the output is turned off
+ *              onDataReady called with each sample of a zone
+ *              ctx        passed to the callbacks
+ * 
+ * Callbacks    void callback(void *ctx, uint8_t zone, int16_t cCelsius)
+ * 
+ * Remarks      A new refresh interval takes effect after the next sample of the zone.
+ *              The deadlines advance with advanceDeadline() of TickScheduler when a zone 
+ *              is taken from the heap, so the time of the conversions is no lateness. The 
+ *              outputs switch with onOffOutput() of NTCthermostat.
+ */
+#ifndef _THERMOSTATMANAGER_H_
+#define _THERMOSTATMANAGER_H_
+#include <Arduino.h>
+#include "NTCsensorArray.h"
+#include "NTCthermostat.h"
+#include "TickScheduler.h"
+
+using ZoneCallback = void (*)(void *ctx, uint8_t zone, int16_t cCelsius);
+
+using Zone = struct zone 
+{ 
+    OnOffLimits limits;               // centi-°C, minimum on and off times
+    uint32_t msInterval;
+    uint32_t msSwitched;              // time of the last transition
+    uint32_t switchCount;
+    bool     isEnabled;
+    bool     isOutputOn;
+};
+
+// Entry of the min-heap
+using ZoneDue = struct zoneDue { uint32_t msDue; uint8_t zone; };
+
+template <uint8_t N>
+class ThermostatManager
+{
+    static_assert(N > 0, "at least one zone");
+
+    public:
+        ThermostatManager(NTCsensorArray<N> &sensors, ZoneCallback onLowTemp, ZoneCallback onHighTemp, 
+                          ZoneCallback onDataReady, void *ctx = nullptr) : 
+                          _sensors(sensors), _onLowTemp(onLowTemp), _onHighTemp(onHighTemp), 
+                          _onDataReady(onDataReady), _ctx(ctx)
+        {
+            for (uint8_t i = 0; i < N; i++) _zones[i] = { { 1800, 2100, 0, 0 }, 5000, 0, 0, true, false };
+        }
+
+        /**
+         * Schedule all zones, zone i first at msNow + i/N of its interval
+         */
+        void start()
+        {
+            uint32_t msNow = millis();
+
+            for (uint8_t i = 0; i < N; i++) 
+            {
+                _heap[i] = { msNow + (uint32_t)((uint64_t)_zones[i].msInterval * i / N), i };
+            }
+            for (int16_t i = N / 2 - 1; i >= 0; i--) _siftDown(i);
+            _isSampling = false;
+            _isRunning  = true;
+        }
+
+        void stop()
+        {
+            _isRunning = false;
+        }
+
+        bool isRunning()
+        {
+            return _isRunning;
+        }
+
+        /**
+         * Sample the zone at the top of the heap when it is due. 
+         * O(1) if nothing is due.
+         */
+        void loop()
+        {
+            if (! _isRunning) return;
+            if (! _isSampling)
+            {
+                _zone = _heap[0].zone;
+                if (! advanceDeadline(_heap[0].msDue, _zones[_zone].msInterval, millis(), _ticks)) return;
+                _siftDown(0);
+                _isSampling = true;
+            }
+            if (! _sensors.update(_zone)) return;
+            _isSampling = false;
+
+            Zone   &z = _zones[_zone];
+            int16_t c = _sensors.getCentiCelsius(_zone);
+            if (z.isEnabled) _switchOutput(_zone, c, _sensors.getTimestamp(_zone));
+            if (_onDataReady != nullptr) _onDataReady(_ctx, _zone, c);
+        }
+
+        void setLimits(uint8_t zone, float tLimitLow, float tLimitHigh)
+        {
+            _zones[zone].limits.cLimitLow  = _toCenti(tLimitLow);
+            _zones[zone].limits.cLimitHigh = _toCenti(tLimitHigh);
+        }
+
+        void setRefreshInterval(uint8_t zone, uint32_t msInterval) { _zones[zone].msInterval = msInterval > 0 ? msInterval : 1; }
+        void setMinOnTime(uint8_t zone, uint32_t msMinOn)          { _zones[zone].limits.msMinOn  = msMinOn; }
+        void setMinOffTime(uint8_t zone, uint32_t msMinOff)        { _zones[zone].limits.msMinOff = msMinOff; }
+        void enableZone(uint8_t zone, bool isEnabled)              { _zones[zone].isEnabled = isEnabled; }
+
+        uint8_t  size()                              { return N; }
+        Zone    &getZone(uint8_t zone)               { return _zones[zone]; }
+        bool     isOutputOn(uint8_t zone)            { return _zones[zone].isOutputOn; }
+        int16_t  getCentiCelsius(uint8_t zone)       { return _sensors.getCentiCelsius(zone); }
+        uint32_t getSwitchCount(uint8_t zone)        { return _zones[zone].switchCount; }
+        uint32_t getLateTicks()                      { return _ticks.lateTicks; }    // over all zones
+        uint32_t getMissedTicks()                    { return _ticks.missedTicks; }
+        uint32_t getMaxLateness()                    { return _ticks.msMaxLate; }
+        uint32_t getNextDue()                        { return _heap[0].msDue; } // millis() of the next sample
+
+        /**
+         * Time until the next zone is due, 0 if one is due or 
+         * a sample is in progress
+         */
+        uint32_t msUntilDue(uint32_t msNow)
+        {
+            int32_t d = (int32_t)(_heap[0].msDue - msNow);
+            return (_isSampling || d < 0) ? 0 : (uint32_t)d;
+        }
+
+    private:
+        NTCsensorArray<N> &_sensors;
+        ZoneCallback _onLowTemp;
+        ZoneCallback _onHighTemp;
+        ZoneCallback _onDataReady;
+        void    *_ctx;
+        Zone     _zones[N];
+        ZoneDue  _heap[N];
+        uint8_t  _zone        = 0;      // zone being sampled
+        bool     _isSampling  = false;
+        bool     _isRunning   = false;
+        TickCounters _ticks   = {};
+
+        void _siftDown(uint8_t i)
+        {
+            ZoneDue e = _heap[i];
+
+            for (;;)
+            {
+                uint8_t c = 2 * i + 1;
+                if (c >= N) break;
+                if (c + 1 < N && _isEarlier(_heap[c + 1], _heap[c])) c++;
+                if (! _isEarlier(_heap[c], e)) break;
+                _heap[i] = _heap[c];
+                i = c;
+            }
+            _heap[i] = e;
+        }
+
+        static bool _isEarlier(const ZoneDue &a, const ZoneDue &b)
+        {
+            return (int32_t)(a.msDue - b.msDue) < 0;
+        }
+
+        void _switchOutput(uint8_t zone, int16_t c, uint32_t ms)
+        {
+            Zone &z    = _zones[zone];
+            bool  isOn = onOffOutput(z.isOutputOn, c, c, z.limits, ms - z.msSwitched, z.switchCount == 0);
+
+            if (isOn == z.isOutputOn) return;
+            z.isOutputOn = isOn;
+            z.msSwitched = ms;
+            z.switchCount++;
+            ZoneCallback cb = isOn ? _onLowTemp : _onHighTemp;
+            if (cb != nullptr) cb(_ctx, zone, c);
+        }
+
+        static int16_t _toCenti(float t)
+        {
+            return (int16_t)(t * 100.0f + (t < 0.0f ? -0.5f : 0.5f));
+        }
+};
+#endif
@@ -0,0 +1,80 @@
+/**
+ * Class        TickScheduler.cpp
+ * Author       2026-10-14 agent
+ *
+ * Purpose      Implements the class TickScheduler, a deadline based periodic timer.
+ *              isDue() returns true exactly once per interval. When loop() was so 
+ *              late that whole intervals have passed, these are counted as missed 
+ *              and the deadline is moved to the next one in phase with the start.
+ * 
+ * Board        Arduino uno, Wemos D1 R2, ESP32 DevKit V1
+ * 
+ **/
+
+#include "TickScheduler.h"
+
+void TickScheduler::start(uint32_t msNow)
+{
+    _msNext = msNow;
+}
+
+bool advanceDeadline(uint32_t &msNext, uint32_t msInterval, uint32_t msNow, TickCounters &counters)
+{
+    int32_t msLate = (int32_t)(msNow - msNext);    // rollover safe 
+    if (msLate < 0) return false;
+
+    uint32_t missed = (uint32_t)msLate / msInterval;
+    if (msLate > 0) counters.lateTicks++;
+    if ((uint32_t)msLate > counters.msMaxLate) counters.msMaxLate = msLate;
+    counters.missedTicks += missed;
+    msNext += (missed + 1) * msInterval;            // stay in phase, no drift
+    return true;
+}
+
+bool TickScheduler::isDue(uint32_t msNow)
+{
+    return advanceDeadline(_msNext, _msInterval, msNow, _counters);
+}
+
+void TickScheduler::setInterval(uint32_t msInterval)
+{
+    if (msInterval == 0) msInterval = 1;
+    _msNext = _msNext - _msInterval + msInterval;  // next tick relative to the last one
+    _msInterval = msInterval;
+}
+
+uint32_t TickScheduler::getInterval()
+{
+    return _msInterval;
+}
+
+uint32_t TickScheduler::getNextDue()
+{
+    return _msNext;
+}
+
+uint32_t TickScheduler::msUntilDue(uint32_t msNow)
+{
+    int32_t msLeft = (int32_t)(_msNext - msNow);
+    return msLeft > 0 ? msLeft : 0;
+}
+
+uint32_t TickScheduler::getLateTicks()
+{
+    return _counters.lateTicks;
+}
+
+uint32_t TickScheduler::getMissedTicks()
+{
+    return _counters.missedTicks;
+}
+
+uint32_t TickScheduler::getMaxLateness()
+{
+    return _counters.msMaxLate;
+}
+
+void TickScheduler::resetStats()
+{
+    _counters = {};
+}
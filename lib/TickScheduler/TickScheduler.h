@@ -0,0 +1,52 @@
+/**
+ * Header       TickScheduler.h
+ * Author       2026-10-14 agent
+ * 
+ * Purpose      Declaration of the class TickScheduler
+ * 
+ * Constructor
+ * arguments    msInterval    the interval between two ticks in milliseconds
+ * 
+ * Remarks      The scheduler keeps the deadline of the next tick instead of testing
+ *              millis() % interval. A tick is never lost when loop() is late and fires
+ *              only once per interval, even if loop() runs several times in the same
+ *              millisecond. Deadlines advance in multiples of the interval so there is 
+ *              no drift. The comparisons use the signed difference of the unsigned 
+ *              times, which keeps working when millis() rolls over after 49.7 days.
+ */
+#ifndef _TICKSCHEDULER_H_
+#define _TICKSCHEDULER_H_
+#include <Arduino.h>
+
+// Counters of a deadline, see advanceDeadline()
+using TickCounters = struct tickCounters { uint32_t lateTicks; uint32_t missedTicks; uint32_t msMaxLate; };
+
+/**
+ * The tick logic of TickScheduler, also used by ThermostatManager for each zone.
+ * Returns false if msNext is not reached yet, else moves msNext to the next deadline 
+ * in phase and counts a late tick and the skipped intervals.
+ */
+bool advanceDeadline(uint32_t &msNext, uint32_t msInterval, uint32_t msNow, TickCounters &counters);
+
+class TickScheduler
+{
+    public:
+        TickScheduler(uint32_t msInterval = 5000) : _msInterval(msInterval > 0 ? msInterval : 1) {}
+
+        void     start(uint32_t msNow);         // the first tick is due at msNow
+        bool     isDue(uint32_t msNow);         // true once per interval, advances the deadline
+        void     setInterval(uint32_t msInterval);
+        uint32_t getInterval();
+        uint32_t getNextDue();                  // millis() at which the next tick is due
+        uint32_t msUntilDue(uint32_t msNow);    // 0 if the tick is due or overdue
+        uint32_t getLateTicks();                // ticks that fired after their deadline
+        uint32_t getMissedTicks();              // intervals skipped because loop() was too late
+        uint32_t getMaxLateness();              // largest delay of a tick in ms
+        void     resetStats();
+
+    private:
+        uint32_t _msInterval;
+        uint32_t _msNext       = 0;
+        TickCounters _counters = {};
+};
+#endif
@@ -42,6 +42,10 @@
  *                         Wemos D1 R2         : A0 = 17
  *                         Doit ESP32 DevKit V1: A6 = 34 
  * 
+ * Output                  The sketch sends a binary telemetry frame with each sample. Run
+ *                         python3 tools/ntc_telemetry.py --port <port> --params 
+ *                         to decode the frames and to request the parameters.
+ * 
  * Build flags             To use the snprintf function for the Arduino Uno, 
  *                         these build flags have to be set:  
  *                         build_flags = -Wl,-u,vfprintf -lprintf_flt -lm
@@ -49,78 +53,83 @@
  */
 
 #include "NTCthermostat.h"
+#include "NTCtelemetry.h"
+#include "NTChistory.h"
+#include "NTCconfig.h"
+#include "NTCfilter.h"
+#include "PowerManager.h"
+#ifdef __AVR__
+  #include "lutNtcRs10kUno.h"   // generated with tools/ntc_lut.py for ntcRs10k and adcUno
+#endif
 
 ParamsNTC ntcRs10k  = { 10000, 10000, 2800 }; // Elegoo NTC module
 ParamsNTC ntcRs20k  = { 20000, 10000, 2800 }; // Elegoo NTC module with additional 10k to Vcc
 
 #ifdef ESP32
-  ParamsADC adcEsp32_0   = { A6, true, 4095, ADC_0db,   3300.0, 1100.0,  65.0 };
-  ParamsADC adcEsp32_2_5 = { A6, true, 4095, ADC_2_5db, 3300.0, 1300.0,  65.0 };
-  ParamsADC adcEsp32_6   = { A6, true, 4095, ADC_6db,   3300.0, 1800.0,  90.0 };
-  ParamsADC adcEsp32_11  = { A6, true, 4095, ADC_11db,  3300.0, 3200.0, 130.0 };
+  ParamsOVS ovsEsp32     = { 16, 2, OVS_TRIMMED };  // 16 conversions, 2 extra bits, without min and max
+  ParamsADC adcEsp32_0   = { A6, true, 4095, ADC_0db,   3300.0, 1100.0,  65.0, &ovsEsp32 };
+  ParamsADC adcEsp32_2_5 = { A6, true, 4095, ADC_2_5db, 3300.0, 1300.0,  65.0, &ovsEsp32 };
+  ParamsADC adcEsp32_6   = { A6, true, 4095, ADC_6db,   3300.0, 1800.0,  90.0, &ovsEsp32 };
+  ParamsADC adcEsp32_11  = { A6, true, 4095, ADC_11db,  3300.0, 3200.0, 130.0, &ovsEsp32 };
+  ParamsADC *const adcEsp32Ranges[] = { &adcEsp32_0, &adcEsp32_2_5, &adcEsp32_6, &adcEsp32_11 };  // auto-ranging
 #else
   ParamsADC adcUno   = { A0, true, 1023, 5000.0, 5000.0, 0.0};
   ParamsADC adcWemos = { A0, true, 1023, 3300.0, 3200.0, -41.0};
 #endif
 
 // Forward declaration of the 3 callbacks
-void turnHeatingOn();
-void turnHeatingOff();
-void processData();
+void turnHeatingOn(void *ctx, const Reading &reading);
+void turnHeatingOff(void *ctx, const Reading &reading);
+void processData(void *ctx, const Reading &reading);
+
+// Heating, passed to the callbacks as context
+using Heating = struct heating { uint8_t pin; NTCthermostat *thermostat; };
 
-NTCsensor     ntcSensor(ntcRs10k, adcUno);
-NTCthermostat thermostat(ntcSensor, turnHeatingOn, turnHeatingOff, processData); // NTCthermostat object
-bool heatingIsOn = false;                                                   // variable for the state of the heating
+extern NTCthermostat thermostat;
+Heating       heating = { LED_BUILTIN, &thermostat };
+#ifdef ESP32
+  NTCsensor   ntcSensor(ntcRs10k, adcEsp32_11);          // range of 11 dB, useAutoRange() in setup()
+#else
+  NTCsensor   ntcSensor(ntcRs10k, adcUno);
+#endif
+NTCthermostat thermostat(ntcSensor, turnHeatingOn, turnHeatingOff, processData, &heating); // NTCthermostat object
+NTCtelemetry  telemetry(Serial, ntcSensor, thermostat);   // binary frames, decode with tools/ntc_telemetry.py
+NTChistory<16, 60, 24> history;                          // last 16 samples, 60 minutes and 24 hours
+NTCconfig     config;                                    // parameters kept in EEPROM / NVS
+EmaFilter     ema(2);                                    // smooths the ADC noise, delay 3 samples
+PowerManager  power(SLEEP_IDLE);                         // SLEEP_LIGHT for battery nodes without serial requests
 
 
 /**
  * Called when temperature drops below low limit
  */
-void turnHeatingOn()
+void turnHeatingOn(void *ctx, const Reading &reading)
   {
-    char buf[80];
-    if (! heatingIsOn)
-    {
-      snprintf(buf, sizeof(buf), "Turn heating on, temperature dropped below limit of %4.1f : %4.1f °C", 
-              (double)thermostat.getLimitLow(), (double)ntcSensor.getCelsius());
-      Serial.println(buf);
-      digitalWrite(LED_BUILTIN, HIGH);            // Simulates turning heating on
-      heatingIsOn = true;
-    }
+    (void)reading;
+    Heating &h = *static_cast<Heating *>(ctx);
+    digitalWrite(h.pin, HIGH);            // Simulates turning heating on
   }
 
 /**
  * Called when tempereature exceeds high limit
  */
-void turnHeatingOff()
+void turnHeatingOff(void *ctx, const Reading &reading)
   {
-    char buf[80];
-    if (heatingIsOn)
-    {
-      snprintf(buf, sizeof(buf), "Turn heating off, temperature exeeds limit of %4.1f : %4.1f °C", 
-              (double)thermostat.getLimitHigh(), (double)ntcSensor.getCelsius());
-      Serial.println(buf);
-      digitalWrite(LED_BUILTIN, LOW);  // Simulates turning off heating
-      heatingIsOn = false;
-    }
+    (void)reading;
+    Heating &h = *static_cast<Heating *>(ctx);
+    digitalWrite(h.pin, LOW);  // Simulates turning off heating
   }
 
-void showValues()
-{
-  char buf[32];
-  ntcSensor.printParams();
-  ntcSensor.printValues();
-  snprintf(buf, sizeof(buf), "Heating is %s\n", heatingIsOn ? "ON" : "OFF");
-  Serial.println(buf);
-}
-
 /**
  * Called every msRefresh milliseconds
- * Do something with the sensor readings
+ * Keep the sample in the history and send it together with the 
+ * state of the heating as telemetry frame
  */
-void processData()
+void processData(void *ctx, const Reading &reading)
 {
-  showValues();
+  (void)ctx;
+  history.push(reading.ms, reading.cCelsius);
+  telemetry.sendSample(reading);
 }
 
 /**
@@ -143,13 +152,28 @@ I2C SDA  = %d
 void setup() 
 {
   Serial.begin(115200);
-  thermostat.setLimitLow(21.0);
-  thermostat.setLimitHigh(22.0);       // sets lower and upper limit to switch a heating on or off
-  thermostat.setRefreshInterval(5000); // sets the refresh interval of the temperature measurement
+  #ifdef __AVR__
+    ntcSensor.useLookupTable(lutNtcRs10kUno);  // no log() on the Uno, dropped if restore() loads other parameters
+  #endif
+  #ifdef ESP32
+    ntcSensor.useAutoRange(adcEsp32Ranges, 4); // resolution of 0 dB with the range of 11 dB
+  #endif
+  if (! config.restore(ntcSensor, thermostat))  // first start, store the defaults
+  {
+    thermostat.setLimitLow(21.0);
+    thermostat.setLimitHigh(22.0);       // sets lower and upper limit to switch a heating on or off
+    thermostat.setRefreshInterval(5000); // sets the refresh interval of the temperature measurement
+    thermostat.setMinOnTime(60000);      // keep the heating on and off for at least a minute
+    thermostat.setMinOffTime(60000);
+    config.store(ntcSensor, thermostat);
+  }
+  thermostat.setFilter(ema.stage());
   thermostat.enable();
 } 
 
 void loop()
 {
   thermostat.loop();     // checks the temperature limits in the cycle of the set interval
+  telemetry.loop();      // sends the buffered frames without blocking, answers parameter requests
+  if (telemetry.isIdle()) power.sleep(thermostat.msUntilDue(millis()));  // until the next tick, a byte at Serial or NTC_SLEEP_MAX
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Program      ntc_lut.py
+
+Purpose      Generates a header with a PROGMEM lookup table of centi-°C for NTCsensor.
+             The table holds the temperature at the analog values i << shift and is 
+             used with NTCsensor::useLookupTable(). The values are calculated with the 
+             same Beta formula as NTCsensor and the maximum interpolation error in the 
+             range tmin .. tmax is written into the header.
+
+Usage        python3 tools/ntc_lut.py --name lutNtcRs10kUno --rs 10000 --ro 10000 --beta 2800 \\
+                     --amax 1023 --vcc 5000 --vref 5000 --voff 0 --size 65 > include/lutNtcRs10kUno.h
+"""
+
+import argparse
+import math
+
+INT16_MIN, INT16_MAX = -32768, 32767
+TABS = -273.15
+TO = 25.0
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Generate an NTCsensor lookup table")
+    ap.add_argument("--name", required=True, help="name of the table")
+    ap.add_argument("--rs", type=float, required=True, help="series resistance in Ohm")
+    ap.add_argument("--ro", type=float, required=True, help="resistance of the NTC at 25 °C")
+    ap.add_argument("--beta", type=float, required=True, help="material constant BETA")
+    ap.add_argument("--amax", type=int, required=True, help="maximum analog value")
+    ap.add_argument("--vcc", type=float, required=True, help="Vcc in mV")
+    ap.add_argument("--vref", type=float, required=True, help="Vref in mV")
+    ap.add_argument("--voff", type=float, default=0.0, help="Voff in mV")
+    ap.add_argument("--ntc-to-vcc", action="store_true", help="NTC connected to Vcc")
+    ap.add_argument("--size", type=int, default=65, help="number of table entries")
+    ap.add_argument("--tmin", type=float, default=-40.0, help="lower end of the error range in °C")
+    ap.add_argument("--tmax", type=float, default=125.0, help="upper end of the error range in °C")
+    a = ap.parse_args()
+
+    roo = a.ro * math.exp(-a.beta / (TO - TABS))
+    v = (a.vref - a.voff) / a.amax
+
+    def rt_of(aval):
+        vin = aval * v + a.voff
+        k = vin / (a.vcc - vin) if vin < a.vcc else math.inf
+        if a.ntc_to_vcc:
+            k = 1.0 / k if k != 0 else math.inf
+        return a.rs * k
+
+    def celsius_of(rt):
+        if not rt > roo:
+            return math.inf
+        return a.beta / math.log(rt / roo) + TABS
+
+    def centi(t):
+        c = t * 100.0
+        if not c < INT16_MAX:
+            return INT16_MAX
+        if c <= INT16_MIN:
+            return INT16_MIN
+        return int(math.floor(c + 0.5)) if c >= 0 else -int(math.floor(-c + 0.5))
+
+    shift = 0
+    while ((a.size - 1) << shift) < a.amax:
+        shift += 1
+    table = [centi(celsius_of(rt_of(i << shift))) for i in range(a.size)]
+
+    def lookup(code):
+        i, frac = code >> shift, code & ((1 << shift) - 1)
+        if i >= a.size - 1:
+            i, frac = a.size - 1, 0
+        t0 = table[i]
+        t1 = table[i + 1] if frac else t0
+        d = (t1 - t0) * frac
+        return t0 + (d >> shift)                  # arithmetic shift as in NTCsensor::_lookup()
+
+    err = 0.0
+    for code in range(a.amax + 1):
+        t = celsius_of(rt_of(code))
+        if a.tmin <= t <= a.tmax:
+            err = max(err, abs(lookup(code) / 100.0 - t))
+
+    guard = "_" + a.name.upper() + "_H_"
+    print("/**")
+    print(" * Header       %s.h" % a.name)
+    print(" * ")
+    print(" * Purpose      Lookup table for NTCsensor generated by tools/ntc_lut.py")
+    print(" *              Rs %g, Ro %g, BETA %g, NTC to %s" % (a.rs, a.ro, a.beta, "Vcc" if a.ntc_to_vcc else "GND"))
+    print(" *              Amax %d, Vcc %g mV, Vref %g mV, Voff %g mV" % (a.amax, a.vcc, a.vref, a.voff))
+    print(" *              %d entries, h = %d, max. error %.3f °C in %g .. %g °C" % (a.size, 1 << shift, err, a.tmin, a.tmax))
+    print(" */")
+    print("#ifndef %s" % guard)
+    print("#define %s" % guard)
+    print('#include "NTCsensor.h"')
+    print()
+    print("const int16_t %sTable[%d] PROGMEM = {" % (a.name, a.size))
+    for i in range(0, a.size, 8):
+        print("    " + ", ".join("%6d" % x for x in table[i:i + 8]) + ("," if i + 8 < a.size else ""))
+    print("};")
+    print("const LutNTC %s = { %sTable, %d, %d, true };" % (a.name, a.name, a.size, shift))
+    print()
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Program      ntc_telemetry.py
+
+Purpose      Decodes the binary telemetry frames of NTCtelemetry. Reads from a serial
+             port (requires pyserial) or from a file with recorded bytes, prints one line 
+             per frame. Bytes which are not part of a valid frame are skipped, so the 
+             decoder resynchronizes after text output or transmission errors.
+
+Frame        0xA5  type  len  payload[len]  crc8      (see lib/NTCtelemetry/NTCtelemetry.h)
+
+Usage        python3 tools/ntc_telemetry.py --port /dev/ttyUSB0 [--baud 115200] [--params]
+             python3 tools/ntc_telemetry.py --file capture.bin
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = 0xA5
+TLM_SAMPLE = 0x01
+TLM_PARAMS = 0x02
+
+
+def crc8(data):
+    crc = 0
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def decode_sample(p):
+    seq, ms, raw, c, flags = struct.unpack("<HIHhB", p)
+    return "sample seq %5d  %10d ms  raw %5d  %7.2f °C  output %s" % (
+        seq, ms, raw, c / 100.0, "ON" if flags & 1 else "OFF")
+
+
+def decode_params(p):
+    (rs, ro, beta, pin, to_gnd, amax, vcc, vref, voff, samples, bits,
+     low, high, refresh) = struct.unpack("<HHHBBHhhhHBhhI", p)
+    return ("params Rs %d  Ro %d  beta %d  pin %d  NTC to %s  Amax %d  Vcc %d mV  Vref %d mV  "
+            "Voff %d mV  samples %d  extra bits %d  limits %.2f .. %.2f °C  refresh %d ms" % (
+                rs, ro, beta, pin, "GND" if to_gnd else "Vcc", amax, vcc, vref, voff,
+                samples, bits, low / 100.0, high / 100.0, refresh))
+
+
+DECODERS = {TLM_SAMPLE: (11, decode_sample), TLM_PARAMS: (27, decode_params)}
+
+
+class Decoder:
+    """Collects bytes and yields decoded frames"""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.skipped = 0
+
+    def feed(self, data):
+        self.buf.extend(data)
+        while True:
+            i = self.buf.find(SYNC)
+            if i < 0:
+                self.skipped += len(self.buf)
+                self.buf.clear()
+                return
+            self.skipped += i
+            del self.buf[:i]
+            if len(self.buf) < 3:
+                return
+            ftype, flen = self.buf[1], self.buf[2]
+            if len(self.buf) < flen + 4:
+                return
+            frame = bytes(self.buf[1:flen + 3])
+            if crc8(frame) != self.buf[flen + 3] or ftype not in DECODERS or DECODERS[ftype][0] != flen:
+                self.skipped += 1
+                del self.buf[:1]
+                continue
+            del self.buf[:flen + 4]
+            yield DECODERS[ftype][1](frame[2:])
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Decode NTCtelemetry frames")
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="serial port")
+    src.add_argument("--file", help="file with recorded bytes")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--params", action="store_true", help="request the parameters")
+    a = ap.parse_args()
+
+    dec = Decoder()
+    if a.file:
+        with open(a.file, "rb") as f:
+            for line in dec.feed(f.read()):
+                print(line)
+        return
+
+    import serial  # pyserial
+    with serial.Serial(a.port, a.baud, timeout=0.2) as port:
+        if a.params:
+            port.write(b"P")
+        try:
+            while True:
+                for line in dec.feed(port.read(256)):
+                    print(line, flush=True)
+        except KeyboardInterrupt:
+            print("%d bytes skipped" % dec.skipped, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()